@@ -29,6 +29,11 @@
       'include_dirs': [ '<!(node -e "require(\'nan\')")' ],
       'sources': [
         'src/main.cc',
+        'src/correction_history.cc',
+        'src/hyphenator.cc',
+        'src/paragraph_cache.cc',
+        'src/token_filter.cc',
+        'src/word_iterator.cc',
       ],
       'conditions': [
         ['spellchecker_use_hunspell=="true"', {
@@ -36,7 +41,10 @@
             'hunspell',
           ],
           'sources': [
+            'src/custom_words.cc',
+            'src/script_table.cc',
             'src/spellchecker_hunspell.cc',
+            'src/suggestion_file.cc',
           ],
         }],
         ['OS=="win"', {
@@ -84,6 +92,8 @@
             'vendor/hunspell/src/hunspell/baseaffix.hxx',
             'vendor/hunspell/src/hunspell/csutil.cxx',
             'vendor/hunspell/src/hunspell/csutil.hxx',
+            'vendor/hunspell/src/hunspell/dafsa.cxx',
+            'vendor/hunspell/src/hunspell/dafsa.hxx',
             'vendor/hunspell/src/hunspell/dictmgr.cxx',
             'vendor/hunspell/src/hunspell/dictmgr.hxx',
             'vendor/hunspell/src/hunspell/filemgr.cxx',
@@ -97,6 +107,8 @@
             'vendor/hunspell/src/hunspell/hunzip.cxx',
             'vendor/hunspell/src/hunspell/hunzip.hxx',
             'vendor/hunspell/src/hunspell/langnum.hxx',
+            'vendor/hunspell/src/hunspell/loadprof.cxx',
+            'vendor/hunspell/src/hunspell/loadprof.hxx',
             'vendor/hunspell/src/hunspell/phonet.cxx',
             'vendor/hunspell/src/hunspell/phonet.hxx',
             'vendor/hunspell/src/hunspell/replist.cxx',
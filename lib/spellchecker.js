@@ -17,9 +17,14 @@ var ensureDefaultSpellCheck = function() {
   setDictionary(lang, getDictionaryPath());
 };
 
-var setDictionary = function(lang, dictPath) {
+var setDictionary = function(lang, dictPath, options) {
   ensureDefaultSpellCheck();
-  return defaultSpellcheck.setDictionary(lang, dictPath);
+  return defaultSpellcheck.setDictionary(lang, dictPath, options);
+};
+
+var setDictionaryFromBuffers = function(aff, dic, options) {
+  ensureDefaultSpellCheck();
+  return defaultSpellcheck.setDictionaryFromBuffers(aff, dic, options);
 };
 
 var isMisspelled = function() {
@@ -28,12 +33,42 @@ var isMisspelled = function() {
   return defaultSpellcheck.isMisspelled.apply(defaultSpellcheck, arguments);
 };
 
+var checkWords = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.checkWords.apply(defaultSpellcheck, arguments);
+};
+
 var checkSpelling = function() {
   ensureDefaultSpellCheck();
 
   return defaultSpellcheck.checkSpelling.apply(defaultSpellcheck, arguments);
 };
 
+var checkSpellingAsync = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.checkSpellingAsync.apply(defaultSpellcheck, arguments);
+};
+
+var cancelCheck = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.cancelCheck.apply(defaultSpellcheck, arguments);
+};
+
+var checkDocument = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.checkDocument.apply(defaultSpellcheck, arguments);
+};
+
+var closeDocument = function() {
+  ensureDefaultSpellCheck();
+
+  defaultSpellcheck.closeDocument.apply(defaultSpellcheck, arguments);
+};
+
 var add = function() {
   ensureDefaultSpellCheck();
 
@@ -46,12 +81,96 @@ var remove = function() {
   defaultSpellcheck.remove.apply(defaultSpellcheck, arguments);
 };
 
+var setCacheSize = function() {
+  ensureDefaultSpellCheck();
+
+  defaultSpellcheck.setCacheSize.apply(defaultSpellcheck, arguments);
+};
+
+var setTokenFilter = function() {
+  ensureDefaultSpellCheck();
+
+  defaultSpellcheck.setTokenFilter.apply(defaultSpellcheck, arguments);
+};
+
+var setHyphenationDictionary = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.setHyphenationDictionary.apply(defaultSpellcheck, arguments);
+};
+
+var hyphenate = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.hyphenate.apply(defaultSpellcheck, arguments);
+};
+
+var hyphenateText = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.hyphenateText.apply(defaultSpellcheck, arguments);
+};
+
+var hyphenateAsync = function() {
+  ensureDefaultSpellCheck();
+
+  defaultSpellcheck.hyphenateAsync.apply(defaultSpellcheck, arguments);
+};
+
 var getCorrectionsForMisspelling = function() {
   ensureDefaultSpellCheck();
 
   return defaultSpellcheck.getCorrectionsForMisspelling.apply(defaultSpellcheck, arguments);
 };
 
+var getSuggestionStats = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.getSuggestionStats.apply(defaultSpellcheck, arguments);
+};
+
+var getLoadProfile = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.getLoadProfile.apply(defaultSpellcheck, arguments);
+};
+
+var writeSuggestionFile = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.writeSuggestionFile.apply(defaultSpellcheck, arguments);
+};
+
+var recordCorrection = function() {
+  ensureDefaultSpellCheck();
+
+  defaultSpellcheck.recordCorrection.apply(defaultSpellcheck, arguments);
+};
+
+var setCorrectionHistoryFile = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.setCorrectionHistoryFile.apply(defaultSpellcheck, arguments);
+};
+
+var autocorrect = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.autocorrect.apply(defaultSpellcheck, arguments);
+};
+
+var autocorrectBatch = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.autocorrectBatch.apply(defaultSpellcheck, arguments);
+};
+
+var complete = function() {
+  ensureDefaultSpellCheck();
+
+  return defaultSpellcheck.complete.apply(defaultSpellcheck, arguments);
+};
+
 var getAvailableDictionaries = function() {
   ensureDefaultSpellCheck();
 
@@ -73,11 +192,32 @@ var getDictionaryPath = function() {
 
 module.exports = {
   setDictionary: setDictionary,
+  setDictionaryFromBuffers: setDictionaryFromBuffers,
   add: add,
   remove: remove,
+  setCacheSize: setCacheSize,
+  setTokenFilter: setTokenFilter,
   isMisspelled: isMisspelled,
+  checkWords: checkWords,
   checkSpelling: checkSpelling,
+  checkSpellingAsync: checkSpellingAsync,
+  cancelCheck: cancelCheck,
+  checkDocument: checkDocument,
+  closeDocument: closeDocument,
   getAvailableDictionaries: getAvailableDictionaries,
   getCorrectionsForMisspelling: getCorrectionsForMisspelling,
+  getSuggestionStats: getSuggestionStats,
+  getLoadProfile: getLoadProfile,
+  writeSuggestionFile: writeSuggestionFile,
+  recordCorrection: recordCorrection,
+  setCorrectionHistoryFile: setCorrectionHistoryFile,
+  autocorrect: autocorrect,
+  autocorrectBatch: autocorrectBatch,
+  complete: complete,
+  setHyphenationDictionary: setHyphenationDictionary,
+  hyphenate: hyphenate,
+  hyphenateText: hyphenateText,
+  hyphenateAsync: hyphenateAsync,
+  WordFlags: bindings.WordFlags,
   Spellchecker: Spellchecker
 };
@@ -0,0 +1,265 @@
+#!/usr/bin/env node
+// Measures the quality and the latency of getCorrectionsForMisspelling with
+// the bundled dictionaries, on the misspellings of spec/typos/<dictionary>.txt.
+// Reports how often the expected correction is the first suggestion (top-1)
+// or one of the first five (top-5), the latency percentiles, and the work of
+// each suggestion generator.
+//
+// Usage: evaluate-suggestions.js [options] [dictionary...]
+//
+//   --rounds <n>          Times each misspelling is corrected, for the latency
+//                         (default 3). The quality is measured in the first.
+//   --json <file>         Writes the results to the file.
+//   --baseline <file>     Compares with the results written by --json before,
+//                         and fails if a dictionary finds fewer expected
+//                         corrections, or is slower than the tolerance.
+//   --latency-tolerance <ratio>
+//                         Slowdown of the median latency allowed by
+//                         --baseline (default 0.5, 50% slower).
+//   --suggestion-file <file>
+//                         Uses the corrections computed beforehand by
+//                         precompute-suggestions.js (with one dictionary).
+//   --compressed          Evaluates each dictionary loaded with the compressed
+//                         option, too, as <dictionary>/compressed, and counts
+//                         the misspellings corrected differently in the modes.
+//
+// The typo files have one misspelling and its expected correction per line,
+// separated by a tab. Lines starting with # are comments.
+
+var fs = require('fs');
+var path = require('path');
+var Spellchecker = require('../lib/spellchecker').Spellchecker;
+
+var dictionaryDirectory = path.join(__dirname, '..', 'spec', 'dictionaries');
+var typoDirectory = path.join(__dirname, '..', 'spec', 'typos');
+
+var usage = function() {
+  console.error('Usage: evaluate-suggestions.js [--rounds <n>] [--json <file>] [--baseline <file>] ' +
+    '[--latency-tolerance <ratio>] [--suggestion-file <file>] [--compressed] [dictionary...]');
+  process.exit(1);
+};
+
+var options = {rounds: 3, latencyTolerance: 0.5, dictionaries: []};
+var args = process.argv.slice(2);
+for (var i = 0; i < args.length; ++i) {
+  var arg = args[i];
+  if (arg.indexOf('--') !== 0) {
+    options.dictionaries.push(arg);
+    continue;
+  }
+  if (arg === '--compressed') {
+    options.compressed = true;
+    continue;
+  }
+
+  var value = args[++i];
+  if (value === undefined) {
+    usage();
+  }
+
+  if (arg === '--rounds') {
+    options.rounds = Math.max(1, parseInt(value, 10) || 0);
+  } else if (arg === '--json') {
+    options.json = value;
+  } else if (arg === '--baseline') {
+    options.baseline = value;
+  } else if (arg === '--latency-tolerance') {
+    options.latencyTolerance = parseFloat(value);
+  } else if (arg === '--suggestion-file') {
+    options.suggestionFile = value;
+  } else {
+    usage();
+  }
+}
+
+// The dictionaries with a typo file, by default
+if (options.dictionaries.length === 0) {
+  options.dictionaries = fs.readdirSync(typoDirectory).filter(function(file) {
+    return path.extname(file) === '.txt';
+  }).map(function(file) {
+    return path.basename(file, '.txt');
+  }).filter(function(dictionary) {
+    return fs.existsSync(path.join(dictionaryDirectory, dictionary + '.aff'));
+  }).sort();
+}
+
+var readTypos = function(dictionary) {
+  var lines = fs.readFileSync(path.join(typoDirectory, dictionary + '.txt'), 'utf8').split(/\r?\n/);
+  var typos = [];
+  lines.forEach(function(line) {
+    if (line.length === 0 || line[0] === '#') {
+      return;
+    }
+
+    var fields = line.split('\t');
+    if (fields.length !== 2) {
+      throw new Error('Bad line in the typos of ' + dictionary + ': ' + line);
+    }
+    typos.push({misspelling: fields[0], correction: fields[1]});
+  });
+  return typos;
+};
+
+// The value below which the given fraction of the sorted values are
+var percentile = function(sorted, fraction) {
+  if (sorted.length === 0) {
+    return 0;
+  }
+  return sorted[Math.min(sorted.length - 1, Math.floor(fraction * sorted.length))];
+};
+
+var elapsedMilliseconds = function(start) {
+  var elapsed = process.hrtime(start);
+  return elapsed[0] * 1e3 + elapsed[1] / 1e6;
+};
+
+// Fills lists with the corrections of each misspelling, in order
+var evaluate = function(dictionary, compressed, lists) {
+  var typos = readTypos(dictionary);
+
+  // NB: A fresh spellchecker, so no learned corrections are used
+  var spellchecker = new Spellchecker();
+  var loadOptions = {suggestionFile: options.suggestionFile, compressed: compressed};
+  if (!spellchecker.setDictionary(dictionary, dictionaryDirectory, loadOptions)) {
+    throw new Error('Cannot load the dictionary ' + dictionary);
+  }
+
+  var result = {pairs: typos.length, top1: 0, top5: 0, suggestions: 0, misses: [], generators: {}};
+  var latencies = [];
+  for (var round = 0; round < options.rounds; ++round) {
+    typos.forEach(function(typo) {
+      spellchecker.getSuggestionStats();
+
+      var start = process.hrtime();
+      var corrections = spellchecker.getCorrectionsForMisspelling(typo.misspelling);
+      latencies.push(elapsedMilliseconds(start));
+
+      var stats = spellchecker.getSuggestionStats();
+      if (round > 0) {
+        return;
+      }
+
+      lists.push(corrections);
+      var rank = corrections.indexOf(typo.correction);
+      if (rank === 0) {
+        result.top1++;
+      }
+      if (rank >= 0 && rank < 5) {
+        result.top5++;
+      } else {
+        result.misses.push(typo.misspelling + ' -> ' + typo.correction);
+      }
+      result.suggestions += corrections.length;
+
+      Object.keys(stats).forEach(function(generator) {
+        var total = result.generators[generator] || (result.generators[generator] = {tried: 0, found: 0});
+        total.tried += stats[generator].tried;
+        total.found += stats[generator].found;
+      });
+    });
+  }
+
+  latencies.sort(function(a, b) { return a - b; });
+  result.latency = {
+    p50: percentile(latencies, 0.5),
+    p90: percentile(latencies, 0.9),
+    p99: percentile(latencies, 0.99),
+    max: latencies[latencies.length - 1] || 0
+  };
+  return result;
+};
+
+var percent = function(count, total) {
+  return total ? (100 * count / total).toFixed(1) + '%' : '-';
+};
+
+var pad = function(value, width) {
+  value = String(value);
+  while (value.length < width) {
+    value = ' ' + value;
+  }
+  return value;
+};
+
+var report = function(dictionary, result) {
+  console.log(dictionary + ': ' + result.pairs + ' misspellings');
+  if (result.differences !== undefined) {
+    console.log('  ' + result.differences + ' corrected differently than uncompressed');
+  }
+  console.log('  top-1 ' + percent(result.top1, result.pairs) +
+    ', top-5 ' + percent(result.top5, result.pairs) +
+    ', ' + (result.pairs ? result.suggestions / result.pairs : 0).toFixed(1) + ' suggestions per word');
+  console.log('  latency p50 ' + result.latency.p50.toFixed(2) + ' ms, p90 ' + result.latency.p90.toFixed(2) +
+    ' ms, p99 ' + result.latency.p99.toFixed(2) + ' ms, max ' + result.latency.max.toFixed(2) + ' ms');
+
+  var generators = Object.keys(result.generators);
+  if (generators.length > 0) {
+    console.log('  ' + pad('generator', 16) + pad('tried/word', 12) + pad('found/word', 12));
+    generators.forEach(function(generator) {
+      var total = result.generators[generator];
+      console.log('  ' + pad(generator, 16) + pad((total.tried / result.pairs).toFixed(1), 12) +
+        pad((total.found / result.pairs).toFixed(2), 12));
+    });
+  }
+
+  result.misses.forEach(function(miss) {
+    console.log('  not in top-5: ' + miss);
+  });
+};
+
+// Returns the regressions from the baseline
+var compare = function(dictionary, result, baseline) {
+  var regressions = [];
+  if (!baseline) {
+    return regressions;
+  }
+
+  if (result.top1 < baseline.top1) {
+    regressions.push(dictionary + ': top-1 ' + baseline.top1 + ' -> ' + result.top1);
+  }
+  if (result.top5 < baseline.top5) {
+    regressions.push(dictionary + ': top-5 ' + baseline.top5 + ' -> ' + result.top5);
+  }
+  if (result.latency.p50 > baseline.latency.p50 * (1 + options.latencyTolerance)) {
+    regressions.push(dictionary + ': latency p50 ' + baseline.latency.p50.toFixed(2) + ' ms -> ' +
+      result.latency.p50.toFixed(2) + ' ms');
+  }
+  return regressions;
+};
+
+var baselines = options.baseline ? JSON.parse(fs.readFileSync(options.baseline, 'utf8')) : {};
+var results = {};
+var regressions = [];
+var run = function(name, result) {
+  results[name] = result;
+  report(name, result);
+  regressions = regressions.concat(compare(name, result, baselines[name]));
+};
+
+options.dictionaries.forEach(function(dictionary) {
+  var lists = [];
+  run(dictionary, evaluate(dictionary, false, lists));
+  if (!options.compressed) {
+    return;
+  }
+
+  // NB: Both modes should find the same corrections, in the same order
+  var compressedLists = [];
+  var result = evaluate(dictionary, true, compressedLists);
+  result.differences = compressedLists.filter(function(corrections, index) {
+    return corrections.join('\n') !== lists[index].join('\n');
+  }).length;
+  run(dictionary + '/compressed', result);
+});
+
+if (options.json) {
+  fs.writeFileSync(options.json, JSON.stringify(results, null, 2) + '\n');
+}
+
+if (regressions.length > 0) {
+  console.error('Regressions from ' + options.baseline + ':');
+  regressions.forEach(function(regression) {
+    console.error('  ' + regression);
+  });
+  process.exit(1);
+}
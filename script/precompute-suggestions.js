@@ -0,0 +1,34 @@
+#!/usr/bin/env node
+// Computes the suggestions of common misspellings for a Hunspell dictionary,
+// into the lang.sug file next to it (or the given file), where setDictionary
+// finds them.
+//
+// Usage: precompute-suggestions.js <lang> <dictionary directory> <misspellings file> [suggestion file]
+//
+// The misspellings file has one word per line.
+
+var fs = require('fs');
+var Spellchecker = require('../lib/spellchecker').Spellchecker;
+
+var args = process.argv.slice(2);
+if (args.length < 3) {
+  console.error('Usage: precompute-suggestions.js <lang> <dictionary directory> <misspellings file> [suggestion file]');
+  process.exit(1);
+}
+
+var misspellings = fs.readFileSync(args[2], 'utf8').split(/\r?\n/).filter(function(word) {
+  return word.length > 0;
+});
+
+var spellchecker = new Spellchecker();
+if (!spellchecker.setDictionary(args[0], args[1])) {
+  console.error('Cannot load the dictionary ' + args[0] + ' from ' + args[1]);
+  process.exit(1);
+}
+
+if (!spellchecker.writeSuggestionFile(misspellings, args[3])) {
+  console.error('Cannot write the suggestion file');
+  process.exit(1);
+}
+
+console.log('Computed the suggestions of ' + misspellings.length + ' misspellings');
@@ -0,0 +1,157 @@
+#include "correction_history.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace spellchecker {
+
+CorrectionHistory::CorrectionHistory() : pairs(0), lines(0) {
+}
+
+bool CorrectionHistory::SetPath(const std::string& path) {
+  corrections.clear();
+  pairs = 0;
+  this->path.clear();
+  lines = 0;
+
+  // NB: Appending creates the file, so a new history can be read too
+  FILE* handle = fopen(path.c_str(), "a+b");
+  if (!handle) {
+    return false;
+  }
+
+  fseek(handle, 0, SEEK_SET);
+  std::string line;
+  for (int c; (c = fgetc(handle)) != EOF; ) {
+    if (c != '\n') {
+      line += (char)c;
+      continue;
+    }
+
+    size_t tab = line.find('\t');
+    if (tab != std::string::npos && tab > 0 && tab + 1 < line.size()) {
+      size_t countTab = line.find('\t', tab + 1);
+      uint32_t count = 1;
+      if (countTab != std::string::npos) {
+        count = (uint32_t)strtoul(line.c_str() + countTab + 1, NULL, 10);
+      }
+      if (count > 0 && countTab != tab + 1) {
+        Learn(line.substr(0, tab), line.substr(tab + 1, countTab - tab - 1), count);
+        lines++;
+      }
+    }
+    line.clear();
+  }
+  fclose(handle);
+
+  this->path = path;
+  if (lines > pairs) {
+    Compact();
+  }
+  return true;
+}
+
+void CorrectionHistory::Record(const std::string& misspelled, const std::string& chosen) {
+  if (misspelled.empty() || chosen.empty() ||
+      misspelled.find_first_of("\t\n") != std::string::npos ||
+      chosen.find_first_of("\t\n") != std::string::npos) {
+    return;
+  }
+
+  Learn(misspelled, chosen, 1);
+
+  if (path.empty()) {
+    return;
+  }
+
+  // NB: The table of the corrections is rewritten once the lines appended
+  // to it outnumber it, so the file grows with the corrections, not the picks
+  if (lines >= kMinCompactLines && lines >= 2 * pairs && Compact()) {
+    return;
+  }
+
+  FILE* handle = fopen(path.c_str(), "ab");
+  if (handle) {
+    std::string line = misspelled + "\t" + chosen + "\n";
+    fwrite(line.data(), 1, line.size(), handle);
+    fclose(handle);
+    lines++;
+  }
+}
+
+// Replaces the file with the table of the corrections. Returns false if it
+// can't be written.
+bool CorrectionHistory::Compact() {
+  std::string table;
+  std::map<std::string, std::vector<Correction> >::const_iterator iter = corrections.begin();
+  for (; iter != corrections.end(); ++iter) {
+    // NB: The last learned come first among equals, so the words are
+    // written from the last to the first to load them in the same order
+    for (size_t i = iter->second.size(); i > 0; --i) {
+      const Correction& correction = iter->second[i - 1];
+      char count[16];
+      snprintf(count, sizeof(count), "%u", correction.count);
+      table += iter->first + "\t" + correction.word + "\t" + count + "\n";
+    }
+  }
+
+  // NB: Written next to the file and renamed over it, so a failure keeps the
+  // previous file
+  std::string temporary = path + ".tmp";
+  FILE* handle = fopen(temporary.c_str(), "wb");
+  if (!handle) {
+    return false;
+  }
+  bool written = fwrite(table.data(), 1, table.size(), handle) == table.size();
+  if (fclose(handle) != 0 || !written) {
+    remove(temporary.c_str());
+    return false;
+  }
+
+#ifdef _WIN32
+  // NB: rename doesn't replace a file on Windows
+  remove(path.c_str());
+#endif
+  if (rename(temporary.c_str(), path.c_str()) != 0) {
+    remove(temporary.c_str());
+    return false;
+  }
+
+  lines = pairs;
+  return true;
+}
+
+void CorrectionHistory::Learn(const std::string& misspelled, const std::string& chosen, uint32_t count) {
+  std::vector<Correction>& words = corrections[misspelled];
+
+  size_t i = 0;
+  while (i < words.size() && words[i].word != chosen) {
+    i++;
+  }
+  if (i == words.size()) {
+    Correction correction = { chosen, 0 };
+    words.push_back(correction);
+    pairs++;
+  }
+  words[i].count += count;
+
+  // Keeps the words sorted, the last picked first among equals
+  for (; i > 0 && words[i - 1].count <= words[i].count; --i) {
+    std::swap(words[i - 1], words[i]);
+  }
+}
+
+std::vector<std::string> CorrectionHistory::GetCorrections(const std::string& misspelled) const {
+  std::vector<std::string> result;
+
+  std::map<std::string, std::vector<Correction> >::const_iterator iter = corrections.find(misspelled);
+  if (iter != corrections.end()) {
+    for (size_t i = 0; i < iter->second.size(); ++i) {
+      result.push_back(iter->second[i].word);
+    }
+  }
+  return result;
+}
+
+}  // namespace spellchecker
@@ -0,0 +1,52 @@
+#ifndef SRC_CORRECTION_HISTORY_H_
+#define SRC_CORRECTION_HISTORY_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace spellchecker {
+
+// Remembers the corrections the user picked for each misspelling, so they
+// are suggested first (and without the suggestion engine) next time. The
+// history can be kept in a file of "misspelling\tcorrection\tcount" lines in
+// UTF-8 (a count of 1 without it): a table of the corrections, followed by
+// the ones picked since it was written, which is compacted into a new table
+// when it is loaded, and when the picks outnumber its lines.
+class CorrectionHistory {
+public:
+  CorrectionHistory();
+
+  // Loads the corrections recorded in the file, and appends the next ones to
+  // it. Returns false if the file can't be read or created.
+  bool SetPath(const std::string& path);
+
+  // Records that the correction was picked for the misspelling.
+  void Record(const std::string& misspelled, const std::string& chosen);
+
+  // Returns the corrections picked for the misspelling, most often picked
+  // first (most recently picked first among equals).
+  std::vector<std::string> GetCorrections(const std::string& misspelled) const;
+
+private:
+  struct Correction {
+    std::string word;
+    uint32_t count;
+  };
+
+  // Lines appended to a file before it is compacted, at least
+  static const size_t kMinCompactLines = 256;
+
+  void Learn(const std::string& misspelled, const std::string& chosen, uint32_t count);
+  bool Compact();
+
+  std::map<std::string, std::vector<Correction> > corrections;
+  size_t pairs;  // Corrections of all the misspellings
+  std::string path;
+  size_t lines;  // Lines of the file
+};
+
+}  // namespace spellchecker
+
+#endif  // SRC_CORRECTION_HISTORY_H_
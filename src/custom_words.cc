@@ -0,0 +1,257 @@
+#include "custom_words.h"
+
+#include <algorithm>
+
+namespace spellchecker {
+
+// A leaf holds a word, a branch the nodes of the words with the same first
+// hash bits, indexed by the next kBits bits. Past the hash bits, a branch
+// holds the words with the same hash in a list.
+struct CustomWords::Node {
+  Node() : leaf(false), bitmap(0), hash(0), kind(kNone) { }
+
+  bool leaf;
+  uint32_t bitmap;  // the bits of the children (branch)
+  std::vector<std::shared_ptr<const Node> > children;  // in bit order
+  uint32_t hash;
+  std::string word;
+  Kind kind;
+};
+
+namespace {
+
+typedef CustomWords::Node Node;
+typedef std::shared_ptr<const Node> NodePtr;
+
+const int kBits = 5;
+const int kHashBits = 32;
+
+uint32_t Hash(const char* word) {
+  uint32_t hash = 2166136261U;  // FNV-1a
+  for (; *word; ++word) {
+    hash = (hash ^ (unsigned char)*word) * 16777619U;
+  }
+  return hash;
+}
+
+// The two bits of the hash in the filter of a snapshot
+uint32_t FilterBit(uint32_t hash, int i) {
+  return (i ? hash * 0x9E3779B1U : hash) >> 19;
+}
+
+bool InFilter(const uint64_t* filter, uint32_t hash) {
+  for (int i = 0; i < 2; ++i) {
+    uint32_t bit = FilterBit(hash, i);
+    if (!(filter[bit / 64] & (1ULL << (bit % 64)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int CountBits(uint32_t bits) {
+  bits = bits - ((bits >> 1) & 0x55555555);
+  bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+  return (((bits + (bits >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+// Returns the trie with the leaf, which replaces the leaf of its word (its
+// kind goes to previous). Only the nodes on the path of the word are copied.
+NodePtr Insert(const NodePtr& node, const NodePtr& leaf, int shift, CustomWords::Kind* previous) {
+  if (!node) {
+    return leaf;
+  }
+
+  if (node->leaf) {
+    if (node->word == leaf->word) {
+      *previous = node->kind;
+      return leaf;
+    }
+    CustomWords::Kind none;
+    NodePtr branch = Insert(std::make_shared<Node>(), node, shift, &none);
+    return Insert(branch, leaf, shift, previous);
+  }
+
+  std::shared_ptr<Node> copy = std::make_shared<Node>(*node);
+  if (shift >= kHashBits) {
+    for (size_t i = 0; i < copy->children.size(); ++i) {
+      if (copy->children[i]->word == leaf->word) {
+        *previous = copy->children[i]->kind;
+        copy->children[i] = leaf;
+        return copy;
+      }
+    }
+    copy->children.push_back(leaf);
+    return copy;
+  }
+
+  uint32_t bit = 1U << ((leaf->hash >> shift) & ((1 << kBits) - 1));
+  size_t i = CountBits(copy->bitmap & (bit - 1));
+  if (copy->bitmap & bit) {
+    copy->children[i] = Insert(copy->children[i], leaf, shift + kBits, previous);
+  } else {
+    copy->bitmap |= bit;
+    copy->children.insert(copy->children.begin() + i, leaf);
+  }
+  return copy;
+}
+
+void CollectAdded(const Node* node, std::vector<const char*>& words) {
+  if (!node) {
+    return;
+  }
+  if (node->leaf) {
+    if (node->kind == CustomWords::kAdded) {
+      words.push_back(node->word.c_str());
+    }
+    return;
+  }
+  for (size_t i = 0; i < node->children.size(); ++i) {
+    CollectAdded(node->children[i].get(), words);
+  }
+}
+
+std::vector<uint32_t> DecodeUTF8(const std::string& text) {
+  std::vector<uint32_t> result;
+  const unsigned char *p = (const unsigned char *)text.data();
+  const unsigned char *end = p + text.size();
+
+  while (p < end) {
+    uint32_t c = *p++;
+    if (c >= 0xC0) {
+      int extra = c >= 0xF0 ? 3 : (c >= 0xE0 ? 2 : 1);
+      c &= 0x3F >> extra;
+      for (; extra > 0 && p < end && (*p & 0xC0) == 0x80; --extra) {
+        c = (c << 6) | (*p++ & 0x3F);
+      }
+    }
+    result.push_back(c);
+  }
+  return result;
+}
+
+// Optimal string alignment distance, or limit + 1 when it is over the limit
+size_t Distance(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, size_t limit) {
+  size_t difference = a.size() > b.size() ? a.size() - b.size() : b.size() - a.size();
+  if (difference > limit) {
+    return limit + 1;
+  }
+
+  std::vector<std::vector<size_t> > d(a.size() + 1, std::vector<size_t>(b.size() + 1));
+  for (size_t i = 0; i <= a.size(); ++i) {
+    d[i][0] = i;
+  }
+  for (size_t j = 0; j <= b.size(); ++j) {
+    d[0][j] = j;
+  }
+
+  for (size_t i = 1; i <= a.size(); ++i) {
+    size_t best = limit + 1;
+    for (size_t j = 1; j <= b.size(); ++j) {
+      size_t cost = a[i - 1] == b[j - 1] ? 0 : 1;
+      d[i][j] = std::min(std::min(d[i - 1][j] + 1, d[i][j - 1] + 1), d[i - 1][j - 1] + cost);
+      if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+        d[i][j] = std::min(d[i][j], d[i - 2][j - 2] + 1);
+      }
+      best = std::min(best, d[i][j]);
+    }
+    if (best > limit) {
+      return limit + 1;
+    }
+  }
+  return std::min(d[a.size()][b.size()], limit + 1);
+}
+
+}  // namespace
+
+CustomWords::CustomWords() : snapshot(std::make_shared<Snapshot>()) { }
+
+std::shared_ptr<const CustomWords::Snapshot> CustomWords::Get() const {
+  return std::atomic_load(&snapshot);
+}
+
+void CustomWords::Add(const std::string& word) {
+  Set(word, kAdded);
+}
+
+void CustomWords::Remove(const std::string& word) {
+  Set(word, kRemoved);
+}
+
+void CustomWords::Set(const std::string& word, Kind kind) {
+  std::shared_ptr<Node> leaf = std::make_shared<Node>();
+  leaf->leaf = true;
+  leaf->hash = Hash(word.c_str());
+  leaf->word = word;
+  leaf->kind = kind;
+
+  std::shared_ptr<const Snapshot> current = Get();
+  std::shared_ptr<Snapshot> next = std::make_shared<Snapshot>(*current);
+  for (int i = 0; i < 2; ++i) {
+    uint32_t bit = FilterBit(leaf->hash, i);
+    next->filter[bit / 64] |= 1ULL << (bit % 64);
+  }
+  Kind previous = kNone;
+  next->root = Insert(current->root, leaf, 0, &previous);
+  next->added = current->added + (kind == kAdded) - (previous == kAdded);
+  next->removed = current->removed + (kind == kRemoved) - (previous == kRemoved);
+  std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>(next));
+}
+
+void CustomWords::Clear() {
+  std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>(std::make_shared<Snapshot>()));
+}
+
+CustomWords::Kind CustomWords::Lookup(const Snapshot& snapshot, const char* word) {
+  uint32_t hash = Hash(word);
+  if (!InFilter(snapshot.filter, hash)) {
+    return kNone;
+  }
+
+  const Node* node = snapshot.root.get();
+  for (int shift = 0; node && !node->leaf; shift += kBits) {
+    if (shift >= kHashBits) {
+      for (size_t i = 0; i < node->children.size(); ++i) {
+        if (node->children[i]->word == word) {
+          return node->children[i]->kind;
+        }
+      }
+      return kNone;
+    }
+
+    uint32_t bit = 1U << ((hash >> shift) & ((1 << kBits) - 1));
+    if (!(node->bitmap & bit)) {
+      return kNone;
+    }
+    node = node->children[CountBits(node->bitmap & (bit - 1))].get();
+  }
+  return (node && node->word == word) ? node->kind : kNone;
+}
+
+void CustomWords::GetAdded(const Snapshot& snapshot, std::vector<const char*>& words) {
+  CollectAdded(snapshot.root.get(), words);
+}
+
+std::vector<std::string> CustomWords::FindNear(const Snapshot& snapshot, const std::string& word,
+                                               size_t maxDistance) {
+  std::vector<std::pair<size_t, std::string> > near;
+  std::vector<uint32_t> text = DecodeUTF8(word);
+
+  std::vector<const char*> added;
+  GetAdded(snapshot, added);
+  for (size_t i = 0; i < added.size(); ++i) {
+    size_t distance = Distance(text, DecodeUTF8(added[i]), maxDistance);
+    if (distance > 0 && distance <= maxDistance) {
+      near.push_back(std::make_pair(distance, std::string(added[i])));
+    }
+  }
+  std::sort(near.begin(), near.end());
+
+  std::vector<std::string> result;
+  for (size_t i = 0; i < near.size(); ++i) {
+    result.push_back(near[i].second);
+  }
+  return result;
+}
+
+}  // namespace spellchecker
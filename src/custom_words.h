@@ -0,0 +1,72 @@
+#ifndef SRC_CUSTOM_WORDS_H_
+#define SRC_CUSTOM_WORDS_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spellchecker {
+
+// The words added and removed by the user on top of a Hunspell dictionary,
+// in UTF-8. Changes never modify the dictionary tables: each one publishes a
+// new immutable snapshot atomically (read-copy-update), so a reader keeps
+// using the snapshot it got, without locks, until it is done. A snapshot is
+// a hash trie sharing its unchanged nodes with the previous one, so a change
+// only copies the path to its word.
+// NB: Writers must be serialized by the caller.
+class CustomWords {
+public:
+  enum Kind {
+    kNone = 0,
+    kAdded = 1,
+    kRemoved = -1
+  };
+
+  struct Node;
+
+  // Bits of the filter of a snapshot, which rejects most other words
+  // without walking the trie
+  static const size_t kFilterBits = 8192;
+
+  struct Snapshot {
+    Snapshot() : added(0), removed(0), filter() { }
+
+    std::shared_ptr<const Node> root;
+    size_t added;
+    size_t removed;
+    uint64_t filter[kFilterBits / 64];
+  };
+
+  CustomWords();
+
+  std::shared_ptr<const Snapshot> Get() const;
+
+  void Add(const std::string& word);
+  void Remove(const std::string& word);
+  void Clear();
+
+  static bool IsEmpty(const Snapshot& snapshot) { return !snapshot.added && !snapshot.removed; }
+
+  // Returns kAdded or kRemoved for the words added or removed last, kNone
+  // otherwise.
+  static Kind Lookup(const Snapshot& snapshot, const char* word);
+
+  // Appends the added words, which live as long as the snapshot.
+  static void GetAdded(const Snapshot& snapshot, std::vector<const char*>& words);
+
+  // Returns the added words within maxDistance edits (insertions, deletions,
+  // replacements and transpositions of characters) of the word, closest
+  // first.
+  static std::vector<std::string> FindNear(const Snapshot& snapshot, const std::string& word,
+                                           size_t maxDistance);
+
+private:
+  void Set(const std::string& word, Kind kind);
+
+  std::shared_ptr<const Snapshot> snapshot;
+};
+
+}  // namespace spellchecker
+
+#endif  // SRC_CUSTOM_WORDS_H_
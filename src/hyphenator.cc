@@ -0,0 +1,263 @@
+#include "hyphenator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwctype>
+
+#include "word_iterator.h"
+
+namespace spellchecker {
+
+namespace {
+
+// Decodes a line of the patterns to UTF-16
+void DecodeLine(const char *line, size_t length, bool utf8, std::vector<uint16_t>& result) {
+  result.clear();
+  const unsigned char *p = (const unsigned char *)line;
+  const unsigned char *end = p + length;
+
+  while (p < end) {
+    uint32_t c = *p++;
+    if (utf8 && c >= 0xC0) {
+      int extra = c >= 0xF0 ? 3 : (c >= 0xE0 ? 2 : 1);
+      c &= 0x3F >> extra;
+      for (; extra > 0 && p < end && (*p & 0xC0) == 0x80; --extra) {
+        c = (c << 6) | (*p++ & 0x3F);
+      }
+    }
+
+    if (c >= 0x10000) {
+      result.push_back(0xD800 + ((c - 0x10000) >> 10));
+      result.push_back(0xDC00 + ((c - 0x10000) & 0x3FF));
+    } else {
+      result.push_back(c);
+    }
+  }
+}
+
+// NB: The keywords of the patterns files are in capitals, the patterns in
+// lowercase
+bool IsKeyword(const char *line) {
+  return *line >= 'A' && *line <= 'Z';
+}
+
+}  // namespace
+
+Hyphenator::Hyphenator() : leftMin(2), rightMin(2) {
+  memset(rootChildren, 0, sizeof(rootChildren));
+}
+
+void Hyphenator::Clear() {
+  leftMin = 2;
+  rightMin = 2;
+  firstEdges.clear();
+  edgeChars.clear();
+  edgeNodes.clear();
+  firstValues.clear();
+  valuePositions.clear();
+  values.clear();
+  memset(rootChildren, 0, sizeof(rootChildren));
+}
+
+bool Hyphenator::IsLoaded() const {
+  return !firstEdges.empty();
+}
+
+// NB: The compound patterns before NEXTLEVEL are merged with the word
+// patterns, and the non-standard ones (with a replacement after a slash)
+// are dropped.
+bool Hyphenator::Load(const std::string& path) {
+  Clear();
+
+  FILE* handle = fopen(path.c_str(), "rb");
+  if (!handle) {
+    return false;
+  }
+
+  std::string data;
+  char buffer[4096];
+  for (size_t size; (size = fread(buffer, 1, sizeof(buffer), handle)) > 0; ) {
+    data.append(buffer, size);
+  }
+  fclose(handle);
+
+  // The root of the trie, with the index 0
+  std::vector<Edges> edges(1);
+  std::vector<Values> nodeValues(1);
+
+  bool encoding = false, utf8 = false;
+  std::vector<uint16_t> pattern;
+  for (size_t start = 0, end; start < data.size(); start = end + 1) {
+    end = data.find('\n', start);
+    if (end == std::string::npos) {
+      end = data.size();
+    }
+
+    size_t last = end;
+    while (last > start && isspace((unsigned char)data[last - 1])) {
+      last--;
+    }
+    if (last == start || data[start] == '%' || data[start] == '#') {
+      continue;
+    }
+
+    std::string line = data.substr(start, last - start);
+    if (!encoding) {
+      encoding = true;
+      utf8 = line == "UTF-8";
+      if (!utf8 && line != "ISO8859-1" && line != "ISO-8859-1") {
+        return false;
+      }
+    } else if (IsKeyword(line.c_str())) {
+      if (line.compare(0, 14, "LEFTHYPHENMIN ") == 0) {
+        leftMin = std::max(1, atoi(line.c_str() + 14));
+      } else if (line.compare(0, 15, "RIGHTHYPHENMIN ") == 0) {
+        rightMin = std::max(1, atoi(line.c_str() + 15));
+      }
+    } else if (line.find('/') == std::string::npos) {
+      DecodeLine(line.data(), line.size(), utf8, pattern);
+      AddPattern(pattern, edges, nodeValues);
+    }
+  }
+
+  Pack(edges, nodeValues);
+  return true;
+}
+
+// Adds a pattern like "a1b2c": the letters go in the trie and the digits
+// between them are the values of the positions
+void Hyphenator::AddPattern(const std::vector<uint16_t>& pattern, std::vector<Edges>& edges,
+                            std::vector<Values>& nodeValues) {
+  uint32_t node = 0;
+  uint8_t position = 0;
+  Values patternValues;
+
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    uint16_t c = pattern[i];
+    if (c >= '0' && c <= '9') {
+      if (c > '0') {
+        patternValues.push_back(std::make_pair(position, (uint8_t)(c - '0')));
+      }
+      continue;
+    }
+
+    if (position == kMaxWordLength + 2) {
+      return;
+    }
+    position++;
+
+    Edges::iterator iter = edges[node].begin();
+    while (iter != edges[node].end() && iter->first != c) {
+      ++iter;
+    }
+
+    if (iter != edges[node].end()) {
+      node = iter->second;
+    } else {
+      uint32_t child = edges.size();
+      edges[node].push_back(std::make_pair(c, child));
+      edges.push_back(Edges());
+      nodeValues.push_back(Values());
+      node = child;
+    }
+  }
+
+  if (node != 0) {
+    nodeValues[node] = patternValues;
+  }
+}
+
+void Hyphenator::Pack(std::vector<Edges>& edges, const std::vector<Values>& nodeValues) {
+  firstEdges.reserve(edges.size() + 1);
+  firstValues.reserve(edges.size() + 1);
+
+  for (size_t node = 0; node < edges.size(); ++node) {
+    std::sort(edges[node].begin(), edges[node].end());
+
+    firstEdges.push_back(edgeChars.size());
+    for (size_t i = 0; i < edges[node].size(); ++i) {
+      edgeChars.push_back(edges[node][i].first);
+      edgeNodes.push_back(edges[node][i].second);
+    }
+
+    firstValues.push_back(values.size());
+    for (size_t i = 0; i < nodeValues[node].size(); ++i) {
+      valuePositions.push_back(nodeValues[node][i].first);
+      values.push_back(nodeValues[node][i].second);
+    }
+  }
+
+  firstEdges.push_back(edgeChars.size());
+  firstValues.push_back(values.size());
+
+  for (uint16_t c = 0; c < 256; ++c) {
+    rootChildren[c] = FindChild(0, c);
+  }
+}
+
+// Returns the child of the node for the character, 0 (the root) if none
+uint32_t Hyphenator::FindChild(uint32_t node, uint16_t c) const {
+  const uint16_t *first = edgeChars.data() + firstEdges[node];
+  const uint16_t *last = edgeChars.data() + firstEdges[node + 1];
+  const uint16_t *edge = std::lower_bound(first, last, c);
+  if (edge == last || *edge != c) {
+    return 0;
+  }
+  return edgeNodes[edge - edgeChars.data()];
+}
+
+void Hyphenator::Hyphenate(const uint16_t *word, size_t length, std::vector<size_t>& points) const {
+  if (!IsLoaded() || length == 0 || length > kMaxWordLength) {
+    return;
+  }
+
+  // The word in lowercase between dots, which the patterns use for its ends
+  uint16_t text[kMaxWordLength + 2];
+  uint8_t levels[kMaxWordLength + 3];
+  size_t size = length + 2;
+
+  text[0] = '.';
+  for (size_t i = 0; i < length; ++i) {
+    text[i + 1] = towlower(word[i]);
+  }
+  text[length + 1] = '.';
+  memset(levels, 0, size + 1);
+
+  // Liang: the highest value of the patterns matching at each position wins
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t node = text[i] < 256 ? rootChildren[text[i]] : FindChild(0, text[i]);
+    for (size_t j = i + 1; node != 0; ++j) {
+      for (uint32_t k = firstValues[node]; k < firstValues[node + 1]; ++k) {
+        uint8_t& level = levels[i + valuePositions[k]];
+        level = std::max(level, values[k]);
+      }
+
+      node = j < size ? FindChild(node, text[j]) : 0;
+    }
+  }
+
+  // Odd values are hyphenation points, levels[p] is before text[p]
+  for (size_t p = leftMin + 1; p + rightMin <= length + 1; ++p) {
+    if (levels[p] & 1) {
+      points.push_back(p - 1);
+    }
+  }
+}
+
+void Hyphenator::HyphenateText(const uint16_t *text, size_t length, std::vector<size_t>& points) const {
+  WordIterator words(text, length);
+
+  size_t start, end;
+  while (words.Next(&start, &end)) {
+    size_t count = points.size();
+    Hyphenate(text + start, end - start, points);
+    for (size_t i = count; i < points.size(); ++i) {
+      points[i] += start;
+    }
+  }
+}
+
+}  // namespace spellchecker
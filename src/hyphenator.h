@@ -0,0 +1,63 @@
+#ifndef SRC_HYPHENATOR_H_
+#define SRC_HYPHENATOR_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace spellchecker {
+
+// Finds the hyphenation points of words with the Liang patterns of a
+// hyph_*.dic file (the format of libhyphen, used by LibreOffice).
+class Hyphenator {
+public:
+  Hyphenator();
+
+  // Loads the patterns of a hyph_*.dic file in UTF-8 or ISO8859-1. Returns
+  // false if it can't be read.
+  bool Load(const std::string& path);
+  bool IsLoaded() const;
+
+  // Appends the offsets in the word where it may be hyphenated.
+  void Hyphenate(const uint16_t *word, size_t length, std::vector<size_t>& points) const;
+
+  // Appends the offsets in the text where its words may be hyphenated. The
+  // words are the ones CheckSpelling checks.
+  void HyphenateText(const uint16_t *text, size_t length, std::vector<size_t>& points) const;
+
+private:
+  // Words are hyphenated in a buffer on the stack, longer ones aren't
+  static const size_t kMaxWordLength = 126;
+
+  typedef std::vector<std::pair<uint16_t, uint32_t> > Edges;
+  typedef std::vector<std::pair<uint8_t, uint8_t> > Values;
+
+  void Clear();
+  void AddPattern(const std::vector<uint16_t>& pattern, std::vector<Edges>& edges,
+                  std::vector<Values>& nodeValues);
+  void Pack(std::vector<Edges>& edges, const std::vector<Values>& nodeValues);
+  uint32_t FindChild(uint32_t node, uint16_t c) const;
+
+  int leftMin;
+  int rightMin;
+
+  // The patterns in a trie of UTF-16 characters, packed at load: the edges
+  // of each node are sorted by character, in one array for all the nodes
+  std::vector<uint32_t> firstEdges;   // per node, and one past the last node
+  std::vector<uint16_t> edgeChars;
+  std::vector<uint32_t> edgeNodes;
+
+  // The children of the root for the Latin-1 characters, where the matches
+  // start at every position of the words
+  uint32_t rootChildren[256];
+
+  // The values of the pattern ending at each node, as pairs of a position
+  // and a value, up to the first position of the next node
+  std::vector<uint32_t> firstValues;  // per node, and one past the last node
+  std::vector<uint8_t> valuePositions;
+  std::vector<uint8_t> values;
+};
+
+}  // namespace spellchecker
+
+#endif  // SRC_HYPHENATOR_H_
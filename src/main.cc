@@ -1,6 +1,14 @@
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <vector>
+#include <cwctype>
 #include "nan.h"
 #include "spellchecker.h"
+#include "paragraph_cache.h"
+#include "hyphenator.h"
+#include "correction_history.h"
 
 using Nan::ObjectWrap;
 using namespace spellchecker;
@@ -8,9 +16,207 @@ using namespace v8;
 
 namespace {
 
+// Number of UTF-16 characters checked at once by checkSpellingAsync, between
+// two looks at the cancellation flag.
+const size_t kCheckChunkLength = 1024;
+
+// Default memory budget of the paragraph cache
+const size_t kDefaultCacheSize = 4 * 1024 * 1024;
+
+class ScopedLock {
+ public:
+  explicit ScopedLock(uv_mutex_t* mutex) : mutex(mutex) {
+    uv_mutex_lock(mutex);
+  }
+
+  ~ScopedLock() {
+    uv_mutex_unlock(mutex);
+  }
+
+ private:
+  uv_mutex_t* mutex;
+};
+
+static Local<Array> MisspelledRangesToArray(const std::vector<MisspelledRange>& ranges) {
+  Local<Array> result = Nan::New<Array>(ranges.size());
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    Local<Object> misspelled_range = Nan::New<Object>();
+    misspelled_range->Set(Nan::New("start").ToLocalChecked(), Nan::New<Integer>((uint32_t)ranges[i].start));
+    misspelled_range->Set(Nan::New("end").ToLocalChecked(), Nan::New<Integer>((uint32_t)ranges[i].end));
+    result->Set(i, misspelled_range);
+  }
+  return result;
+}
+
+static bool IsBefore(const MisspelledRange& a, const MisspelledRange& b) {
+  return a.start < b.start || (a.start == b.start && a.end < b.end);
+}
+
+// Merges the sorted previous and current ranges of a document into the
+// added and removed ones.
+static void DiffMisspelledRanges(const std::vector<MisspelledRange>& previous,
+                                 const std::vector<MisspelledRange>& current,
+                                 std::vector<MisspelledRange>& added,
+                                 std::vector<MisspelledRange>& removed) {
+  size_t i = 0, j = 0;
+  while (i < previous.size() || j < current.size()) {
+    if (j == current.size() || (i < previous.size() && IsBefore(previous[i], current[j]))) {
+      removed.push_back(previous[i++]);
+    } else if (i == previous.size() || IsBefore(current[j], previous[i])) {
+      added.push_back(current[j++]);
+    } else {
+      i++;
+      j++;
+    }
+  }
+}
+
+static Local<Array> PointsToArray(const std::vector<size_t>& points) {
+  Local<Array> result = Nan::New<Array>(points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    result->Set(i, Nan::New<Integer>((uint32_t)points[i]));
+  }
+  return result;
+}
+
+// Copies the strings of an array as UTF-16, other values as empty strings
+static std::vector<std::vector<uint16_t> > ToUTF16Strings(Local<Array> array) {
+  std::vector<std::vector<uint16_t> > strings(array->Length());
+  for (uint32_t i = 0; i < array->Length(); ++i) {
+    Local<Value> value = array->Get(i);
+    if (value->IsString()) {
+      Local<String> string = value.As<String>();
+      strings[i].resize(string->Length() + 1);
+      string->Write(reinterpret_cast<uint16_t *>(strings[i].data()));
+      strings[i].pop_back();
+    }
+  }
+  return strings;
+}
+
+class Spellchecker;
+
+// Part of the text, in UTF-16 characters
+struct TextRegion {
+  size_t start;
+  size_t end;
+};
+
+// Misspellings of a checked region, streamed to onRegion
+struct CheckedRegion {
+  TextRegion region;
+  std::vector<MisspelledRange> ranges;
+};
+
+class CheckSpellingWorker : public Nan::AsyncProgressWorker {
+ public:
+  CheckSpellingWorker(Spellchecker* owner, Nan::Callback* callback, Nan::Callback* onRegion,
+                      uint32_t id, const std::string& channel, const uint16_t* text, size_t length,
+                      const std::vector<TextRegion>& priorities);
+  ~CheckSpellingWorker();
+
+  void Execute(const ExecutionProgress& progress);
+  void HandleProgressCallback(const char* data, size_t size);
+  void HandleOKCallback();
+
+  // Checks the text on the main thread instead of in Execute, for the
+  // implementations bound to it
+  void CheckOnMainThread();
+
+  // Removes the listener of the abort signal when the check completes
+  void SetAbortListener(Local<Object> signal, Local<Function> listener);
+
+  void Cancel() {
+    cancelled.store(true, std::memory_order_release);
+  }
+
+  bool IsCancelled() const {
+    return cancelled.load(std::memory_order_acquire);
+  }
+
+  void SetDocument(const std::string& document) {
+    this->document = document;
+  }
+
+  uint32_t GetId() const { return id; }
+  const std::string& GetChannel() const { return channel; }
+
+ private:
+  void Check(const ExecutionProgress* progress);
+  void StreamCheckedRegions();
+  void RemoveAbortListener();
+
+  Spellchecker* owner;
+  Nan::Callback* onRegion;
+  uint32_t id;
+  std::string channel;
+  std::string document;
+  std::vector<uint16_t> text;
+  std::vector<TextRegion> plan;
+  std::vector<MisspelledRange> result;
+
+  // Regions checked by the worker, not yet passed to onRegion
+  uv_mutex_t checkedLock;
+  std::vector<CheckedRegion> checked;
+
+  // NB: Only set by the main thread, and polled by the worker between chunks
+  std::atomic<bool> cancelled;
+
+  bool checkedOnMainThread;
+  bool hasAbortListener;
+};
+
+// Hyphenates words, or the words of a text (passed as the only one, with its
+// NUL), on a background thread
+class HyphenateWorker : public Nan::AsyncWorker {
+ public:
+  HyphenateWorker(std::shared_ptr<const Hyphenator> hyphenator, Nan::Callback* callback,
+                  const std::vector<std::vector<uint16_t> >& words, bool text)
+    : Nan::AsyncWorker(callback), hyphenator(hyphenator), words(words), text(text) { }
+
+  void Execute();
+  void HandleOKCallback();
+
+ private:
+  std::shared_ptr<const Hyphenator> hyphenator;
+  std::vector<std::vector<uint16_t> > words;
+  bool text;
+  std::vector<std::vector<size_t> > points;
+};
+
 class Spellchecker : public Nan::ObjectWrap {
   SpellcheckerImplementation* impl;
 
+  // Serializes the use of impl and cache by the main thread and the async
+  // checks
+  uv_mutex_t lock;
+
+  ParagraphCache cache;
+  CorrectionHistory history;
+
+  // Changes of the word list (Add and Remove, which don't take the lock), and
+  // the change the paragraph cache has seen
+  std::atomic<uint32_t> wordsVersion;
+  uint32_t cacheVersion;
+
+  // NB: A loaded hyphenator is never modified, so it is used without lock by
+  // the main thread and the async hyphenations holding it. Loading a new
+  // dictionary replaces it.
+  std::shared_ptr<const Hyphenator> hyphenator;
+
+  std::map<uint32_t, CheckSpellingWorker*> checks;
+  std::map<std::string, uint32_t> channels;
+  uint32_t lastCheckId;
+
+  // Last check of each document
+  struct DocumentCheck {
+    uint32_t id;
+    std::vector<MisspelledRange> ranges;
+  };
+  std::map<std::string, DocumentCheck> documents;
+
+  friend class CheckSpellingWorker;
+
   static NAN_METHOD(New) {
     Nan::HandleScope scope;
     Spellchecker* that = new Spellchecker();
@@ -34,10 +240,49 @@ class Spellchecker : public Nan::ObjectWrap {
       directory = *String::Utf8Value(info[1]);
     }
 
-    bool result = that->impl->SetDictionary(language, directory);
+    DictionaryOptions options = ToDictionaryOptions(info[2]);
+
+    ScopedLock lock(&that->lock);
+    that->cache.Clear();
+    bool result = that->impl->SetDictionary(language, directory, options);
+    info.GetReturnValue().Set(Nan::New(result));
+  }
+
+  static NAN_METHOD(SetDictionaryFromBuffers) {
+    Nan::HandleScope scope;
+
+    if (info.Length() < 2 || !node::Buffer::HasInstance(info[0]) || !node::Buffer::HasInstance(info[1])) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    Local<Object> aff = info[0]->ToObject();
+    Local<Object> dic = info[1]->ToObject();
+    DictionaryOptions options = ToDictionaryOptions(info[2]);
+
+    ScopedLock lock(&that->lock);
+    that->cache.Clear();
+    bool result = that->impl->SetDictionaryFromBuffers(
+      node::Buffer::Data(aff), node::Buffer::Length(aff),
+      node::Buffer::Data(dic), node::Buffer::Length(dic), options);
     info.GetReturnValue().Set(Nan::New(result));
   }
 
+  static DictionaryOptions ToDictionaryOptions(Local<Value> value) {
+    DictionaryOptions options;
+    if (value->IsObject()) {
+      Local<Object> object = value->ToObject();
+      options.compressed = object->Get(Nan::New("compressed").ToLocalChecked())->BooleanValue();
+      options.profile = object->Get(Nan::New("profile").ToLocalChecked())->BooleanValue();
+      Local<Value> suggestionFile = object->Get(Nan::New("suggestionFile").ToLocalChecked());
+      if (suggestionFile->IsString()) {
+        options.suggestionFile = *String::Utf8Value(suggestionFile);
+      }
+    }
+    return options;
+  }
+
   static NAN_METHOD(IsMisspelled) {
     Nan::HandleScope scope;
     if (info.Length() < 1) {
@@ -47,9 +292,81 @@ class Spellchecker : public Nan::ObjectWrap {
     Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
     std::string word = *String::Utf8Value(info[0]);
 
+    ScopedLock lock(&that->lock);
     info.GetReturnValue().Set(Nan::New(that->impl->IsMisspelled(word)));
   }
 
+  // Returns {misspelled, flags} typed arrays with an entry per word, and with
+  // the roots option the rootIds of the words (-1 for none) in the roots array.
+  static NAN_METHOD(CheckWords) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsArray()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    Local<Array> array = Local<Array>::Cast(info[0]);
+    std::vector<std::string> words(array->Length());
+    for (uint32_t i = 0; i < array->Length(); ++i) {
+      words[i] = *String::Utf8Value(array->Get(i));
+    }
+
+    bool withRoots = false;
+    if (info.Length() > 1 && info[1]->IsObject()) {
+      Local<Object> options = info[1]->ToObject();
+      withRoots = options->Get(Nan::New("roots").ToLocalChecked())->BooleanValue();
+    }
+
+    std::vector<WordInfo> results;
+    {
+      ScopedLock lock(&that->lock);
+      results = that->impl->CheckWords(words, withRoots);
+    }
+
+    Isolate* isolate = Isolate::GetCurrent();
+    Local<ArrayBuffer> misspelledBuffer = ArrayBuffer::New(isolate, results.size());
+    Local<ArrayBuffer> flagsBuffer = ArrayBuffer::New(isolate, results.size());
+    uint8_t* misspelled = static_cast<uint8_t*>(misspelledBuffer->GetContents().Data());
+    uint8_t* flags = static_cast<uint8_t*>(flagsBuffer->GetContents().Data());
+    for (size_t i = 0; i < results.size(); ++i) {
+      misspelled[i] = results[i].misspelled;
+      flags[i] = results[i].flags;
+    }
+
+    Local<Object> result = Nan::New<Object>();
+    result->Set(Nan::New("misspelled").ToLocalChecked(), Uint8Array::New(misspelledBuffer, 0, results.size()));
+    result->Set(Nan::New("flags").ToLocalChecked(), Uint8Array::New(flagsBuffer, 0, results.size()));
+
+    if (withRoots) {
+      // NB: Inflected forms share their root, so each one is only sent once
+      Local<ArrayBuffer> rootIdsBuffer = ArrayBuffer::New(isolate, results.size() * sizeof(int32_t));
+      int32_t* rootIds = static_cast<int32_t*>(rootIdsBuffer->GetContents().Data());
+      std::map<std::string, int32_t> ids;
+      Local<Array> roots = Nan::New<Array>();
+      for (size_t i = 0; i < results.size(); ++i) {
+        const std::string& root = results[i].root;
+        if (root.empty()) {
+          rootIds[i] = -1;
+          continue;
+        }
+
+        std::map<std::string, int32_t>::iterator iter = ids.find(root);
+        if (iter == ids.end()) {
+          int32_t id = static_cast<int32_t>(ids.size());
+          iter = ids.insert(std::make_pair(root, id)).first;
+          roots->Set(id, Nan::New(root.data(), root.size()).ToLocalChecked());
+        }
+        rootIds[i] = iter->second;
+      }
+
+      result->Set(Nan::New("rootIds").ToLocalChecked(), Int32Array::New(rootIdsBuffer, 0, results.size()));
+      result->Set(Nan::New("roots").ToLocalChecked(), roots);
+    }
+
+    info.GetReturnValue().Set(result);
+  }
+
   static NAN_METHOD(CheckSpelling) {
     Nan::HandleScope scope;
     if (info.Length() < 1) {
@@ -72,18 +389,61 @@ class Spellchecker : public Nan::ObjectWrap {
     string->Write(reinterpret_cast<uint16_t *>(text.data()));
 
     Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
-    std::vector<MisspelledRange> misspelled_ranges = that->impl->CheckSpelling(text.data(), text.size());
+    std::vector<MisspelledRange> misspelled_ranges;
+    {
+      ScopedLock lock(&that->lock);
+      misspelled_ranges = that->CheckSpellingCached(text.data(), text.size());
+    }
 
-    std::vector<MisspelledRange>::const_iterator iter = misspelled_ranges.begin();
-    for (; iter != misspelled_ranges.end(); ++iter) {
-      size_t index = iter - misspelled_ranges.begin();
-      uint32_t start = iter->start, end = iter->end;
+    info.GetReturnValue().Set(MisspelledRangesToArray(misspelled_ranges));
+  }
 
-      Local<Object> misspelled_range = Nan::New<Object>();
-      misspelled_range->Set(Nan::New("start").ToLocalChecked(), Nan::New<Integer>(start));
-      misspelled_range->Set(Nan::New("end").ToLocalChecked(), Nan::New<Integer>(end));
-      result->Set(index, misspelled_range);
+  static NAN_METHOD(CheckDocument) {
+    Nan::HandleScope scope;
+    if (info.Length() < 2 || !info[0]->IsString() || !info[1]->IsString()) {
+      return Nan::ThrowError("Bad argument");
     }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    std::string document = *String::Utf8Value(info[0]);
+    Handle<String> string = Handle<String>::Cast(info[1]);
+
+    std::vector<uint16_t> text(string->Length() + 1);
+    string->Write(reinterpret_cast<uint16_t *>(text.data()));
+
+    std::vector<MisspelledRange> misspelled_ranges;
+    if (string->Length() > 0) {
+      ScopedLock lock(&that->lock);
+      misspelled_ranges = that->CheckSpellingCached(text.data(), text.size());
+    }
+
+    info.GetReturnValue().Set(that->UpdateDocument(document, ++that->lastCheckId, misspelled_ranges));
+  }
+
+  static NAN_METHOD(CloseDocument) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+    that->documents.erase(*String::Utf8Value(info[0]));
+  }
+
+  // Remembers the ranges of the check of the document, and returns an object
+  // with the added and removed ones
+  Local<Object> UpdateDocument(const std::string& document, uint32_t id, std::vector<MisspelledRange>& ranges) {
+    DocumentCheck& previous = documents[document];
+    std::vector<MisspelledRange> added, removed;
+    DiffMisspelledRanges(previous.ranges, ranges, added, removed);
+    previous.id = id;
+    previous.ranges.swap(ranges);
+
+    Local<Object> result = Nan::New<Object>();
+    result->Set(Nan::New("added").ToLocalChecked(), MisspelledRangesToArray(added));
+    result->Set(Nan::New("removed").ToLocalChecked(), MisspelledRangesToArray(removed));
+    return result;
   }
 
   static NAN_METHOD(Add) {
@@ -95,7 +455,11 @@ class Spellchecker : public Nan::ObjectWrap {
     Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
     std::string word = *String::Utf8Value(info[0]);
 
+    // NB: Without the lock, so a running check doesn't delay the change
+    // (see SpellcheckerImplementation::Add), which drops the paragraph cache
+    // at the next check
     that->impl->Add(word);
+    that->wordsVersion++;
     return;
   }
   
@@ -108,11 +472,134 @@ class Spellchecker : public Nan::ObjectWrap {
     Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
     std::string word = *String::Utf8Value(info[0]);
 
+    // NB: Without the lock, so a running check doesn't delay the change
+    // (see SpellcheckerImplementation::Add), which drops the paragraph cache
+    // at the next check
     that->impl->Remove(word);
+    that->wordsVersion++;
     return;
   }
 
 
+  static NAN_METHOD(SetCacheSize) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsNumber()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    ScopedLock lock(&that->lock);
+    that->cache.SetCapacity(info[0]->Uint32Value());
+  }
+
+  static NAN_METHOD(SetTokenFilter) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsObject()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    Local<Object> object = info[0]->ToObject();
+    TokenFilter filter;
+    filter.ignoreAllCaps = object->Get(Nan::New("ignoreAllCaps").ToLocalChecked())->BooleanValue();
+    filter.ignoreMixedCase = object->Get(Nan::New("ignoreMixedCase").ToLocalChecked())->BooleanValue();
+    filter.ignoreWordsWithDigits = object->Get(Nan::New("ignoreWordsWithDigits").ToLocalChecked())->BooleanValue();
+    filter.minLength = object->Get(Nan::New("minLength").ToLocalChecked())->Uint32Value();
+    filter.maxLength = object->Get(Nan::New("maxLength").ToLocalChecked())->Uint32Value();
+
+    ScopedLock lock(&that->lock);
+    that->cache.Clear();
+    that->impl->SetTokenFilter(filter);
+  }
+
+  static NAN_METHOD(SetHyphenationDictionary) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsString()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+    std::string path = *String::Utf8Value(info[0]);
+
+    std::shared_ptr<Hyphenator> hyphenator = std::make_shared<Hyphenator>();
+    bool loaded = hyphenator->Load(path);
+    that->hyphenator = hyphenator;
+    info.GetReturnValue().Set(Nan::New(loaded));
+  }
+
+  static NAN_METHOD(Hyphenate) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsArray()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    Local<Array> words = Local<Array>::Cast(info[0]);
+    Local<Array> result = Nan::New<Array>(words->Length());
+    std::vector<uint16_t> word;
+    std::vector<size_t> points;
+
+    const Hyphenator& hyphenator = *that->hyphenator;
+    for (uint32_t i = 0; i < words->Length(); ++i) {
+      points.clear();
+
+      Local<Value> value = words->Get(i);
+      if (value->IsString()) {
+        Local<String> string = value.As<String>();
+        word.resize(string->Length() + 1);
+        string->Write(reinterpret_cast<uint16_t *>(word.data()));
+        hyphenator.Hyphenate(word.data(), string->Length(), points);
+      }
+      result->Set(i, PointsToArray(points));
+    }
+
+    info.GetReturnValue().Set(result);
+  }
+
+  static NAN_METHOD(HyphenateText) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsString()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+    Local<String> string = info[0].As<String>();
+
+    std::vector<uint16_t> text(string->Length() + 1);
+    string->Write(reinterpret_cast<uint16_t *>(text.data()));
+
+    std::vector<size_t> points;
+    that->hyphenator->HyphenateText(text.data(), text.size(), points);
+
+    info.GetReturnValue().Set(PointsToArray(points));
+  }
+
+  static NAN_METHOD(HyphenateAsync) {
+    Nan::HandleScope scope;
+    if (info.Length() < 2 || !(info[0]->IsArray() || info[0]->IsString()) || !info[1]->IsFunction()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    std::vector<std::vector<uint16_t> > words;
+    if (info[0]->IsString()) {
+      Local<String> string = info[0].As<String>();
+      words.resize(1);
+      words[0].resize(string->Length() + 1);
+      string->Write(reinterpret_cast<uint16_t *>(words[0].data()));
+    } else {
+      words = ToUTF16Strings(Local<Array>::Cast(info[0]));
+    }
+
+    Nan::Callback* callback = new Nan::Callback(info[1].As<Function>());
+    HyphenateWorker* worker = new HyphenateWorker(that->hyphenator, callback, words, info[0]->IsString());
+    Nan::AsyncQueueWorker(worker);
+  }
+
   static NAN_METHOD(GetAvailableDictionaries) {
     Nan::HandleScope scope;
 
@@ -123,6 +610,7 @@ class Spellchecker : public Nan::ObjectWrap {
       std::string path = *String::Utf8Value(info[0]);
     }
 
+    ScopedLock lock(&that->lock);
     std::vector<std::string> dictionaries =
       that->impl->GetAvailableDictionaries(path);
 
@@ -144,8 +632,25 @@ class Spellchecker : public Nan::ObjectWrap {
     Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
 
     std::string word = *String::Utf8Value(info[0]);
-    std::vector<std::string> corrections =
-      that->impl->GetCorrectionsForMisspelling(word);
+    bool learnedOnly = false;
+    if (info.Length() > 1 && info[1]->IsObject()) {
+      Local<Object> options = info[1]->ToObject();
+      learnedOnly = options->Get(Nan::New("learnedOnly").ToLocalChecked())->BooleanValue();
+    }
+
+    // The corrections picked before come first, and may spare the search
+    std::vector<std::string> corrections = that->history.GetCorrections(word);
+    if (!learnedOnly || corrections.empty()) {
+      ScopedLock lock(&that->lock);
+      std::vector<std::string> suggestions =
+        that->impl->GetCorrectionsForMisspelling(word);
+
+      for (size_t i = 0; i < suggestions.size(); ++i) {
+        if (std::find(corrections.begin(), corrections.end(), suggestions[i]) == corrections.end()) {
+          corrections.push_back(suggestions[i]);
+        }
+      }
+    }
 
     Local<Array> result = Nan::New<Array>(corrections.size());
     for (size_t i = 0; i < corrections.size(); ++i) {
@@ -158,13 +663,343 @@ class Spellchecker : public Nan::ObjectWrap {
     info.GetReturnValue().Set(result);
   }
 
-  Spellchecker() {
+  // Returns {generator: {tried, found}} for the corrections searched since the
+  // previous call
+  static NAN_METHOD(GetSuggestionStats) {
+    Nan::HandleScope scope;
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    std::vector<SuggestionStat> stats;
+    {
+      ScopedLock lock(&that->lock);
+      stats = that->impl->TakeSuggestionStats();
+    }
+
+    Local<Object> result = Nan::New<Object>();
+    for (size_t i = 0; i < stats.size(); ++i) {
+      Local<Object> stat = Nan::New<Object>();
+      stat->Set(Nan::New("tried").ToLocalChecked(), Nan::New<Number>(stats[i].tried));
+      stat->Set(Nan::New("found").ToLocalChecked(), Nan::New<Number>(stats[i].found));
+      result->Set(Nan::New(stats[i].generator).ToLocalChecked(), stat);
+    }
+
+    info.GetReturnValue().Set(result);
+  }
+
+  // Returns [{phase, milliseconds, calls, allocations, bytes}] for the last
+  // dictionary loaded with the profile option
+  static NAN_METHOD(GetLoadProfile) {
+    Nan::HandleScope scope;
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    std::vector<LoadPhaseProfile> phases;
+    {
+      ScopedLock lock(&that->lock);
+      phases = that->impl->GetLoadProfile();
+    }
+
+    Local<Array> result = Nan::New<Array>(phases.size());
+    for (size_t i = 0; i < phases.size(); ++i) {
+      Local<Object> phase = Nan::New<Object>();
+      phase->Set(Nan::New("phase").ToLocalChecked(), Nan::New(phases[i].phase).ToLocalChecked());
+      phase->Set(Nan::New("milliseconds").ToLocalChecked(), Nan::New<Number>(phases[i].milliseconds));
+      phase->Set(Nan::New("calls").ToLocalChecked(), Nan::New<Number>(phases[i].calls));
+      phase->Set(Nan::New("allocations").ToLocalChecked(), Nan::New<Number>(phases[i].allocations));
+      phase->Set(Nan::New("bytes").ToLocalChecked(), Nan::New<Number>(phases[i].bytes));
+      result->Set(i, phase);
+    }
+
+    info.GetReturnValue().Set(result);
+  }
+
+  static NAN_METHOD(WriteSuggestionFile) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsArray()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    Local<Array> words = Local<Array>::Cast(info[0]);
+    std::vector<std::string> misspellings;
+    for (uint32_t i = 0; i < words->Length(); ++i) {
+      misspellings.push_back(*String::Utf8Value(words->Get(i)));
+    }
+
+    std::string path;
+    if (info.Length() > 1 && info[1]->IsString()) {
+      path = *String::Utf8Value(info[1]);
+    }
+
+    ScopedLock lock(&that->lock);
+    info.GetReturnValue().Set(Nan::New(that->impl->WriteSuggestionFile(path, misspellings)));
+  }
+
+  static NAN_METHOD(RecordCorrection) {
+    Nan::HandleScope scope;
+    if (info.Length() < 2 || !info[0]->IsString() || !info[1]->IsString()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+    that->history.Record(*String::Utf8Value(info[0]), *String::Utf8Value(info[1]));
+  }
+
+  static NAN_METHOD(SetCorrectionHistoryFile) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsString()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+    std::string path = *String::Utf8Value(info[0]);
+    info.GetReturnValue().Set(Nan::New(that->history.SetPath(path)));
+  }
+
+  static NAN_METHOD(Autocorrect) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    std::string word = *String::Utf8Value(info[0]);
+    ScopedLock lock(&that->lock);
+    std::string correction = that->impl->GetAutocorrection(word);
+
+    if (correction.empty()) {
+      info.GetReturnValue().SetNull();
+    } else {
+      info.GetReturnValue().Set(Nan::New(correction.data(), correction.size()).ToLocalChecked());
+    }
+  }
+
+  static NAN_METHOD(AutocorrectBatch) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsArray()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    Local<Array> words = Local<Array>::Cast(info[0]);
+    Local<Array> result = Nan::New<Array>(words->Length());
+    ScopedLock lock(&that->lock);
+    for (uint32_t i = 0; i < words->Length(); ++i) {
+      std::string word = *String::Utf8Value(words->Get(i));
+      std::string correction = that->impl->GetAutocorrection(word);
+
+      if (correction.empty()) {
+        result->Set(i, Nan::Null());
+      } else {
+        result->Set(i, Nan::New(correction.data(), correction.size()).ToLocalChecked());
+      }
+    }
+
+    info.GetReturnValue().Set(result);
+  }
+
+  static NAN_METHOD(Complete) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    std::string prefix = *String::Utf8Value(info[0]);
+    int limit = 10;
+    int maxEdits = 0;
+    if (info.Length() > 1 && info[1]->IsObject()) {
+      Local<Object> options = info[1]->ToObject();
+      Local<Value> value = options->Get(Nan::New("limit").ToLocalChecked());
+      if (value->IsNumber()) {
+        limit = value->Int32Value();
+      }
+      value = options->Get(Nan::New("maxEdits").ToLocalChecked());
+      if (value->IsNumber()) {
+        maxEdits = value->Int32Value();
+      }
+    }
+
+    ScopedLock lock(&that->lock);
+    std::vector<std::string> completions =
+      that->impl->GetCompletions(prefix, limit, maxEdits);
+
+    Local<Array> result = Nan::New<Array>(completions.size());
+    for (size_t i = 0; i < completions.size(); ++i) {
+      const std::string& word = completions[i];
+
+      Nan::MaybeLocal<String> val = Nan::New<String>(word.data(), word.size());
+      result->Set(i, val.ToLocalChecked());
+    }
+
+    info.GetReturnValue().Set(result);
+  }
+
+  static NAN_METHOD(CheckSpellingAsync) {
+    Nan::HandleScope scope;
+    if (info.Length() < 2 || !info[info.Length() - 1]->IsFunction()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Handle<String> string = Handle<String>::Cast(info[0]);
+    if (!string->IsString()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+
+    std::string channel;
+    Local<Object> signal;
+    std::vector<TextRegion> regions;
+    Nan::Callback* onRegion = NULL;
+    std::string document;
+    if (info.Length() > 2 && info[1]->IsObject()) {
+      Local<Object> options = info[1]->ToObject();
+      Local<Value> value = options->Get(Nan::New("channel").ToLocalChecked());
+      if (value->IsString()) {
+        channel = *String::Utf8Value(value);
+      }
+      value = options->Get(Nan::New("signal").ToLocalChecked());
+      if (value->IsObject()) {
+        signal = value->ToObject();
+      }
+      value = options->Get(Nan::New("regions").ToLocalChecked());
+      if (value->IsArray()) {
+        Local<Array> array = Local<Array>::Cast(value);
+        for (uint32_t i = 0; i < array->Length(); ++i) {
+          if (!array->Get(i)->IsObject()) {
+            continue;
+          }
+          Local<Object> object = array->Get(i)->ToObject();
+          TextRegion region;
+          region.start = object->Get(Nan::New("start").ToLocalChecked())->Uint32Value();
+          region.end = object->Get(Nan::New("end").ToLocalChecked())->Uint32Value();
+          regions.push_back(region);
+        }
+      }
+      value = options->Get(Nan::New("onRegion").ToLocalChecked());
+      if (value->IsFunction()) {
+        onRegion = new Nan::Callback(value.As<Function>());
+      }
+      value = options->Get(Nan::New("document").ToLocalChecked());
+      if (value->IsString()) {
+        document = *String::Utf8Value(value);
+      }
+    }
+
+    std::vector<uint16_t> text(string->Length() + 1);
+    string->Write(reinterpret_cast<uint16_t *>(text.data()));
+
+    uint32_t id = ++that->lastCheckId;
+    Nan::Callback* callback = new Nan::Callback(info[info.Length() - 1].As<Function>());
+    CheckSpellingWorker* worker = new CheckSpellingWorker(that, callback, onRegion, id, channel,
+                                                          text.data(), text.size(), regions);
+    worker->SaveToPersistent("spellchecker", info.Holder());
+    worker->SetDocument(document);
+    that->checks[id] = worker;
+
+    // Latest wins: a new check of a channel supersedes the previous one
+    if (!channel.empty()) {
+      that->Cancel(that->channels[channel]);
+      that->channels[channel] = id;
+    }
+
+    if (!signal.IsEmpty()) {
+      if (signal->Get(Nan::New("aborted").ToLocalChecked())->BooleanValue()) {
+        worker->Cancel();
+      } else {
+        Local<Value> listen = signal->Get(Nan::New("addEventListener").ToLocalChecked());
+        if (listen->IsFunction()) {
+          Local<Array> data = Nan::New<Array>(2);
+          data->Set(0, info.Holder());
+          data->Set(1, Nan::New<Integer>(id));
+          Local<Function> listener = Nan::New<Function>(OnAbort, data);
+          Local<Value> argv[] = { Nan::New("abort").ToLocalChecked(), listener };
+          listen.As<Function>()->Call(signal, 2, argv);
+          worker->SetAbortListener(signal, listener);
+        }
+      }
+    }
+
+    // NB: The OS spellcheckers can only be used on the main thread, so only
+    // the callback is asynchronous
+    if (!that->impl->CanCheckOnAnyThread() && !worker->IsCancelled()) {
+      worker->CheckOnMainThread();
+    }
+
+    Nan::AsyncQueueWorker(worker);
+    info.GetReturnValue().Set(Nan::New<Integer>(id));
+  }
+
+  static NAN_METHOD(OnAbort) {
+    Nan::HandleScope scope;
+    Local<Array> data = info.Data().As<Array>();
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(data->Get(0)->ToObject());
+    that->Cancel(data->Get(1)->Uint32Value());
+  }
+
+  static NAN_METHOD(CancelCheck) {
+    Nan::HandleScope scope;
+    if (info.Length() < 1 || !info[0]->IsNumber()) {
+      return Nan::ThrowError("Bad argument");
+    }
+
+    Spellchecker* that = Nan::ObjectWrap::Unwrap<Spellchecker>(info.Holder());
+    info.GetReturnValue().Set(Nan::New(that->Cancel(info[0]->Uint32Value())));
+  }
+
+  bool Cancel(uint32_t id) {
+    std::map<uint32_t, CheckSpellingWorker*>::iterator iter = checks.find(id);
+    if (iter == checks.end()) {
+      return false;
+    }
+
+    iter->second->Cancel();
+    return true;
+  }
+
+  // Returns true if the ranges of a check of the document newer than id are
+  // remembered
+  bool HasNewerCheck(const std::string& document, uint32_t id) {
+    std::map<std::string, DocumentCheck>::iterator iter = documents.find(document);
+    return iter != documents.end() && iter->second.id > id;
+  }
+
+  // Called on the main thread when the callback of a check is invoked
+  void FinishCheck(CheckSpellingWorker* worker) {
+    checks.erase(worker->GetId());
+
+    std::map<std::string, uint32_t>::iterator iter = channels.find(worker->GetChannel());
+    if (iter != channels.end() && iter->second == worker->GetId()) {
+      channels.erase(iter);
+    }
+  }
+
+  // Same as cache.CheckSpelling, after dropping the paragraphs checked with
+  // an older word list. NB: Needs the lock.
+  std::vector<MisspelledRange> CheckSpellingCached(const uint16_t *text, size_t length) {
+    uint32_t version = wordsVersion;
+    if (version != cacheVersion) {
+      cache.Clear();
+      cacheVersion = version;
+    }
+    return cache.CheckSpelling(impl, text, length);
+  }
+
+  Spellchecker() : cache(kDefaultCacheSize), wordsVersion(0), cacheVersion(0),
+    hyphenator(std::make_shared<Hyphenator>()), lastCheckId(0) {
     impl = SpellcheckerFactory::CreateSpellchecker();
+    uv_mutex_init(&lock);
   }
 
   // actual destructor
   virtual ~Spellchecker() {
     delete impl;
+    uv_mutex_destroy(&lock);
   }
 
  public:
@@ -175,17 +1010,303 @@ class Spellchecker : public Nan::ObjectWrap {
     tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
     Nan::SetMethod(tpl->InstanceTemplate(), "setDictionary", Spellchecker::SetDictionary);
+    Nan::SetMethod(tpl->InstanceTemplate(), "setDictionaryFromBuffers", Spellchecker::SetDictionaryFromBuffers);
     Nan::SetMethod(tpl->InstanceTemplate(), "getAvailableDictionaries", Spellchecker::GetAvailableDictionaries);
     Nan::SetMethod(tpl->InstanceTemplate(), "getCorrectionsForMisspelling", Spellchecker::GetCorrectionsForMisspelling);
+    Nan::SetMethod(tpl->InstanceTemplate(), "getSuggestionStats", Spellchecker::GetSuggestionStats);
+    Nan::SetMethod(tpl->InstanceTemplate(), "getLoadProfile", Spellchecker::GetLoadProfile);
+    Nan::SetMethod(tpl->InstanceTemplate(), "writeSuggestionFile", Spellchecker::WriteSuggestionFile);
+    Nan::SetMethod(tpl->InstanceTemplate(), "recordCorrection", Spellchecker::RecordCorrection);
+    Nan::SetMethod(tpl->InstanceTemplate(), "setCorrectionHistoryFile", Spellchecker::SetCorrectionHistoryFile);
+    Nan::SetMethod(tpl->InstanceTemplate(), "autocorrect", Spellchecker::Autocorrect);
+    Nan::SetMethod(tpl->InstanceTemplate(), "autocorrectBatch", Spellchecker::AutocorrectBatch);
+    Nan::SetMethod(tpl->InstanceTemplate(), "complete", Spellchecker::Complete);
     Nan::SetMethod(tpl->InstanceTemplate(), "isMisspelled", Spellchecker::IsMisspelled);
+    Nan::SetMethod(tpl->InstanceTemplate(), "checkWords", Spellchecker::CheckWords);
     Nan::SetMethod(tpl->InstanceTemplate(), "checkSpelling", Spellchecker::CheckSpelling);
+    Nan::SetMethod(tpl->InstanceTemplate(), "checkSpellingAsync", Spellchecker::CheckSpellingAsync);
+    Nan::SetMethod(tpl->InstanceTemplate(), "cancelCheck", Spellchecker::CancelCheck);
+    Nan::SetMethod(tpl->InstanceTemplate(), "checkDocument", Spellchecker::CheckDocument);
+    Nan::SetMethod(tpl->InstanceTemplate(), "closeDocument", Spellchecker::CloseDocument);
     Nan::SetMethod(tpl->InstanceTemplate(), "add", Spellchecker::Add);
     Nan::SetMethod(tpl->InstanceTemplate(), "remove", Spellchecker::Remove);
+    Nan::SetMethod(tpl->InstanceTemplate(), "setCacheSize", Spellchecker::SetCacheSize);
+    Nan::SetMethod(tpl->InstanceTemplate(), "setTokenFilter", Spellchecker::SetTokenFilter);
+    Nan::SetMethod(tpl->InstanceTemplate(), "setHyphenationDictionary", Spellchecker::SetHyphenationDictionary);
+    Nan::SetMethod(tpl->InstanceTemplate(), "hyphenate", Spellchecker::Hyphenate);
+    Nan::SetMethod(tpl->InstanceTemplate(), "hyphenateText", Spellchecker::HyphenateText);
+    Nan::SetMethod(tpl->InstanceTemplate(), "hyphenateAsync", Spellchecker::HyphenateAsync);
 
     exports->Set(Nan::New("Spellchecker").ToLocalChecked(), tpl->GetFunction());
+
+    Local<Object> flags = Nan::New<Object>();
+    flags->Set(Nan::New("COMPOUND").ToLocalChecked(), Nan::New(WordInfo::kCompound));
+    flags->Set(Nan::New("FORBIDDEN").ToLocalChecked(), Nan::New(WordInfo::kForbidden));
+    flags->Set(Nan::New("WARN").ToLocalChecked(), Nan::New(WordInfo::kWarn));
+    flags->Set(Nan::New("CUSTOM").ToLocalChecked(), Nan::New(WordInfo::kCustom));
+    exports->Set(Nan::New("WordFlags").ToLocalChecked(), flags);
   }
 };
 
+static bool CompareTextRegions(const TextRegion& a, const TextRegion& b) {
+  return a.start < b.start;
+}
+
+// Returns the end of the chunk of the text between start and end: after the
+// last whitespace within kCheckChunkLength characters, so no word is split.
+static size_t ChunkEnd(const std::vector<uint16_t>& text, size_t start, size_t end) {
+  if (end - start <= kCheckChunkLength) {
+    return end;
+  }
+
+  for (size_t i = start + kCheckChunkLength; i > start; --i) {
+    if (iswspace(text[i - 1])) {
+      return i;
+    }
+  }
+
+  for (size_t i = start + kCheckChunkLength; i < end; ++i) {
+    if (iswspace(text[i])) {
+      return i + 1;
+    }
+  }
+  return end;
+}
+
+// Splits the text into the regions to check in order: the parts of the
+// priority regions not covered by the previous ones, widened to whole words,
+// then the rest of the text chunk by chunk.
+static std::vector<TextRegion> PlanRegions(const std::vector<uint16_t>& text,
+                                           const std::vector<TextRegion>& priorities) {
+  std::vector<TextRegion> plan;
+  std::vector<TextRegion> covered;
+
+  for (size_t i = 0; i < priorities.size(); ++i) {
+    size_t start = std::min(priorities[i].start, text.size());
+    size_t end = std::min(priorities[i].end, text.size());
+    if (start >= end) {
+      continue;
+    }
+    while (start > 0 && !iswspace(text[start - 1])) {
+      start--;
+    }
+    while (end < text.size() && !iswspace(text[end - 1])) {
+      end++;
+    }
+
+    size_t count = covered.size();
+    for (size_t j = 0; j < count && start < end; ++j) {
+      if (covered[j].end <= start) {
+        continue;
+      }
+      if (covered[j].start >= end) {
+        break;
+      }
+      if (covered[j].start > start) {
+        TextRegion region = { start, covered[j].start };
+        plan.push_back(region);
+        covered.push_back(region);
+      }
+      start = covered[j].end;
+    }
+    if (start < end) {
+      TextRegion region = { start, end };
+      plan.push_back(region);
+      covered.push_back(region);
+    }
+    std::sort(covered.begin(), covered.end(), CompareTextRegions);
+  }
+
+  size_t start = 0;
+  for (size_t j = 0; j <= covered.size(); ++j) {
+    size_t end = j < covered.size() ? covered[j].start : text.size();
+    while (start < end) {
+      TextRegion region = { start, ChunkEnd(text, start, end) };
+      plan.push_back(region);
+      start = region.end;
+    }
+    if (j < covered.size()) {
+      start = covered[j].end;
+    }
+  }
+  return plan;
+}
+
+CheckSpellingWorker::CheckSpellingWorker(Spellchecker* owner, Nan::Callback* callback, Nan::Callback* onRegion,
+                                         uint32_t id, const std::string& channel, const uint16_t* text,
+                                         size_t length, const std::vector<TextRegion>& priorities)
+  : Nan::AsyncProgressWorker(callback), owner(owner), onRegion(onRegion), id(id), channel(channel),
+    text(text, text + length), cancelled(false), checkedOnMainThread(false), hasAbortListener(false) {
+  plan = PlanRegions(this->text, priorities);
+  uv_mutex_init(&checkedLock);
+}
+
+CheckSpellingWorker::~CheckSpellingWorker() {
+  delete onRegion;
+  uv_mutex_destroy(&checkedLock);
+}
+
+void CheckSpellingWorker::Execute(const ExecutionProgress& progress) {
+  if (!checkedOnMainThread) {
+    Check(&progress);
+  }
+}
+
+void CheckSpellingWorker::CheckOnMainThread() {
+  Check(NULL);
+  checkedOnMainThread = true;
+}
+
+// Checks the regions of the plan in order, passing them to onRegion through
+// the progress events when there is one
+void CheckSpellingWorker::Check(const ExecutionProgress* progress) {
+  for (size_t i = 0; i < plan.size(); ++i) {
+    CheckedRegion region;
+    region.region = plan[i];
+
+    for (size_t start = plan[i].start, end; start < plan[i].end; start = end) {
+      if (IsCancelled()) {
+        return;
+      }
+
+      end = ChunkEnd(text, start, plan[i].end);
+
+      std::vector<MisspelledRange> ranges;
+      {
+        ScopedLock lock(&owner->lock);
+        ranges = owner->CheckSpellingCached(text.data() + start, end - start);
+      }
+
+      std::vector<MisspelledRange>::iterator iter = ranges.begin();
+      for (; iter != ranges.end(); ++iter) {
+        iter->start += start;
+        iter->end += start;
+        region.ranges.push_back(*iter);
+      }
+    }
+
+    result.insert(result.end(), region.ranges.begin(), region.ranges.end());
+
+    if (onRegion) {
+      ScopedLock lock(&checkedLock);
+      checked.push_back(region);
+      // NB: Progress events may be merged, they only wake up the main thread
+      if (progress) {
+        progress->Send(NULL, 0);
+      }
+    }
+  }
+
+  std::sort(result.begin(), result.end(), IsBefore);
+}
+
+void CheckSpellingWorker::StreamCheckedRegions() {
+  std::vector<CheckedRegion> regions;
+  {
+    ScopedLock lock(&checkedLock);
+    regions.swap(checked);
+  }
+
+  for (size_t i = 0; i < regions.size() && !IsCancelled(); ++i) {
+    Local<Object> region = Nan::New<Object>();
+    region->Set(Nan::New("start").ToLocalChecked(), Nan::New<Integer>((uint32_t)regions[i].region.start));
+    region->Set(Nan::New("end").ToLocalChecked(), Nan::New<Integer>((uint32_t)regions[i].region.end));
+
+    Local<Value> argv[] = { region, MisspelledRangesToArray(regions[i].ranges) };
+    onRegion->Call(2, argv);
+  }
+}
+
+void CheckSpellingWorker::SetAbortListener(Local<Object> signal, Local<Function> listener) {
+  SaveToPersistent("signal", signal);
+  SaveToPersistent("abortListener", listener);
+  hasAbortListener = true;
+}
+
+// NB: Otherwise a long-lived signal keeps the spellchecker alive
+void CheckSpellingWorker::RemoveAbortListener() {
+  if (!hasAbortListener) {
+    return;
+  }
+
+  Local<Object> signal = GetFromPersistent("signal").As<Object>();
+  Local<Value> unlisten = signal->Get(Nan::New("removeEventListener").ToLocalChecked());
+  if (unlisten->IsFunction()) {
+    Local<Value> argv[] = { Nan::New("abort").ToLocalChecked(), GetFromPersistent("abortListener") };
+    unlisten.As<Function>()->Call(signal, 2, argv);
+  }
+}
+
+void CheckSpellingWorker::HandleProgressCallback(const char* data, size_t size) {
+  Nan::HandleScope scope;
+  StreamCheckedRegions();
+}
+
+void CheckSpellingWorker::HandleOKCallback() {
+  Nan::HandleScope scope;
+  owner->FinishCheck(this);
+  RemoveAbortListener();
+
+  if (onRegion) {
+    StreamCheckedRegions();
+  }
+
+  // NB: A check of a document completing after a newer one is superseded by
+  // it, so the next changes aren't computed from its stale ranges
+  if (!document.empty() && owner->HasNewerCheck(document, id)) {
+    Cancel();
+  }
+
+  // NB: Also checks cancelled after the last chunk, so superseded results are
+  // never delivered
+  if (IsCancelled()) {
+    Local<Object> error = Nan::Error("Check cancelled").As<Object>();
+    error->Set(Nan::New("name").ToLocalChecked(), Nan::New("AbortError").ToLocalChecked());
+
+    Local<Value> argv[] = { error };
+    callback->Call(1, argv);
+    return;
+  }
+
+  if (!document.empty()) {
+    Local<Value> argv[] = { Nan::Null(), owner->UpdateDocument(document, id, result) };
+    callback->Call(2, argv);
+    return;
+  }
+
+  Local<Value> argv[] = { Nan::Null(), MisspelledRangesToArray(result) };
+  callback->Call(2, argv);
+}
+
+void HyphenateWorker::Execute() {
+  points.resize(words.size());
+  for (size_t i = 0; i < words.size(); ++i) {
+    if (text) {
+      hyphenator->HyphenateText(words[i].data(), words[i].size(), points[i]);
+    } else {
+      hyphenator->Hyphenate(words[i].data(), words[i].size(), points[i]);
+    }
+  }
+}
+
+void HyphenateWorker::HandleOKCallback() {
+  Nan::HandleScope scope;
+
+  Local<Value> result;
+  if (text) {
+    result = PointsToArray(points[0]);
+  } else {
+    Local<Array> array = Nan::New<Array>(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      array->Set(i, PointsToArray(points[i]));
+    }
+    result = array;
+  }
+
+  Local<Value> argv[] = { Nan::Null(), result };
+  callback->Call(2, argv);
+}
+
 void Init(Handle<Object> exports, Handle<Object> module) {
   Spellchecker::Init(exports);
 }
@@ -0,0 +1,153 @@
+#include "paragraph_cache.h"
+
+#include <algorithm>
+
+namespace spellchecker {
+
+ParagraphCache::ParagraphCache(size_t capacity) : capacity(capacity), size(0) { }
+
+// FNV-1a over the UTF-16 characters, with a final mix of the bits. Hits are
+// compared with the stored text, so collisions only cost a miss.
+uint64_t ParagraphCache::Hash(const uint16_t *text, size_t length) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < length; ++i) {
+    hash = (hash ^ text[i]) * 0x100000001b3ULL;
+  }
+
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// NB: Includes an estimate of the list and map nodes
+size_t ParagraphCache::SizeOf(const Paragraph& paragraph) {
+  return sizeof(Paragraph) + 64 + paragraph.text.size() * sizeof(uint16_t) +
+    paragraph.ranges.size() * sizeof(MisspelledRange);
+}
+
+ParagraphCache::ParagraphList::iterator ParagraphCache::Find(uint64_t hash, const uint16_t *text, size_t length) {
+  std::map<uint64_t, ParagraphList::iterator>::iterator iter = index.find(hash);
+  if (iter == index.end()) {
+    return paragraphs.end();
+  }
+
+  ParagraphList::iterator paragraph = iter->second;
+  if (paragraph->text.size() != length || !std::equal(text, text + length, paragraph->text.begin())) {
+    return paragraphs.end();
+  }
+
+  paragraphs.splice(paragraphs.begin(), paragraphs, paragraph);
+  return paragraph;
+}
+
+void ParagraphCache::Insert(uint64_t hash, const uint16_t *text, size_t length,
+                            const std::vector<MisspelledRange>& ranges) {
+  std::map<uint64_t, ParagraphList::iterator>::iterator iter = index.find(hash);
+  if (iter != index.end()) {
+    size -= SizeOf(*iter->second);
+    paragraphs.erase(iter->second);
+    index.erase(iter);
+  }
+
+  Paragraph paragraph;
+  paragraph.hash = hash;
+  paragraph.text.assign(text, text + length);
+  paragraph.ranges = ranges;
+  if (SizeOf(paragraph) > capacity) {
+    return;
+  }
+
+  paragraphs.push_front(paragraph);
+  index[hash] = paragraphs.begin();
+  size += SizeOf(paragraph);
+  Evict();
+}
+
+void ParagraphCache::Evict() {
+  while (size > capacity && !paragraphs.empty()) {
+    size -= SizeOf(paragraphs.back());
+    index.erase(paragraphs.back().hash);
+    paragraphs.pop_back();
+  }
+}
+
+// Checks consecutive missed paragraphs at once, and remembers their ranges
+void ParagraphCache::CheckMisses(SpellcheckerImplementation* impl, const uint16_t *text,
+                                 std::vector<Miss>& misses, std::vector<MisspelledRange>& result) {
+  if (misses.empty()) {
+    return;
+  }
+
+  size_t start = misses.front().start;
+  std::vector<MisspelledRange> ranges = impl->CheckSpelling(text + start, misses.back().end - start);
+
+  size_t j = 0;
+  for (size_t i = 0; i < misses.size(); ++i) {
+    std::vector<MisspelledRange> paragraph_ranges;
+    for (; j < ranges.size() && ranges[j].start + start < misses[i].end; ++j) {
+      MisspelledRange range;
+      range.start = ranges[j].start + start - misses[i].start;
+      range.end = ranges[j].end + start - misses[i].start;
+      paragraph_ranges.push_back(range);
+
+      range.start = ranges[j].start + start;
+      range.end = ranges[j].end + start;
+      result.push_back(range);
+    }
+
+    Insert(misses[i].hash, text + misses[i].start, misses[i].end - misses[i].start, paragraph_ranges);
+  }
+  misses.clear();
+}
+
+std::vector<MisspelledRange> ParagraphCache::CheckSpelling(SpellcheckerImplementation* impl,
+                                                           const uint16_t *text, size_t length) {
+  if (capacity == 0) {
+    return impl->CheckSpelling(text, length);
+  }
+
+  std::vector<MisspelledRange> result;
+  std::vector<Miss> misses;
+
+  // NB: Paragraphs end after a newline, so no word is split
+  for (size_t start = 0, end; start < length; start = end) {
+    for (end = start; end < length && text[end++] != '\n'; ) { }
+
+    uint64_t hash = Hash(text + start, end - start);
+    ParagraphList::iterator paragraph = Find(hash, text + start, end - start);
+    if (paragraph == paragraphs.end()) {
+      Miss miss = { start, end, hash };
+      misses.push_back(miss);
+      continue;
+    }
+
+    // NB: Copied first, checking the misses may evict the paragraph
+    std::vector<MisspelledRange> ranges = paragraph->ranges;
+    CheckMisses(impl, text, misses, result);
+
+    std::vector<MisspelledRange>::const_iterator iter = ranges.begin();
+    for (; iter != ranges.end(); ++iter) {
+      MisspelledRange range;
+      range.start = iter->start + start;
+      range.end = iter->end + start;
+      result.push_back(range);
+    }
+  }
+
+  CheckMisses(impl, text, misses, result);
+  return result;
+}
+
+void ParagraphCache::Clear() {
+  paragraphs.clear();
+  index.clear();
+  size = 0;
+}
+
+void ParagraphCache::SetCapacity(size_t capacity) {
+  this->capacity = capacity;
+  Evict();
+}
+
+}  // namespace spellchecker
@@ -0,0 +1,65 @@
+#ifndef SRC_PARAGRAPH_CACHE_H_
+#define SRC_PARAGRAPH_CACHE_H_
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "spellchecker.h"
+
+namespace spellchecker {
+
+// Remembers the misspellings of the paragraphs (lines) of checked texts, so
+// text repeated across documents, like quotes and templates, is only checked
+// once. NB: Must be cleared when the dictionary changes.
+class ParagraphCache {
+public:
+  explicit ParagraphCache(size_t capacity);
+
+  // Same as impl->CheckSpelling, but only checks the paragraphs which aren't
+  // in the cache.
+  std::vector<MisspelledRange> CheckSpelling(SpellcheckerImplementation* impl,
+                                             const uint16_t *text, size_t length);
+
+  void Clear();
+
+  // Sets the memory budget in bytes, 0 disables the cache.
+  void SetCapacity(size_t capacity);
+
+private:
+  struct Paragraph {
+    uint64_t hash;
+    std::vector<uint16_t> text;
+    std::vector<MisspelledRange> ranges;  // relative to the paragraph
+  };
+
+  typedef std::list<Paragraph> ParagraphList;
+
+  // A paragraph of the text not found in the cache
+  struct Miss {
+    size_t start;
+    size_t end;
+    uint64_t hash;
+  };
+
+  static uint64_t Hash(const uint16_t *text, size_t length);
+  static size_t SizeOf(const Paragraph& paragraph);
+
+  ParagraphList::iterator Find(uint64_t hash, const uint16_t *text, size_t length);
+  void Insert(uint64_t hash, const uint16_t *text, size_t length,
+              const std::vector<MisspelledRange>& ranges);
+  void CheckMisses(SpellcheckerImplementation* impl, const uint16_t *text,
+                   std::vector<Miss>& misses, std::vector<MisspelledRange>& result);
+  void Evict();
+
+  size_t capacity;
+  size_t size;
+
+  // Most recently used first
+  ParagraphList paragraphs;
+  std::map<uint64_t, ParagraphList::iterator> index;
+};
+
+}  // namespace spellchecker
+
+#endif  // SRC_PARAGRAPH_CACHE_H_
@@ -0,0 +1,184 @@
+#include "script_table.h"
+
+#include <ctype.h>
+#include <string.h>
+
+namespace spellchecker {
+
+namespace {
+
+struct ScriptRange {
+  uint16_t first;
+  uint16_t last;
+  Script script;
+};
+
+// The letter blocks of the scripts, sorted. NB: The characters of the
+// astral planes are in surrogate pairs, only the high surrogates of the CJK
+// ideographs are classified.
+const ScriptRange kScriptRanges[] = {
+  { 0x00C0, 0x024F, kScriptLatin },
+  { 0x0250, 0x02AF, kScriptLatin },  // IPA
+  { 0x0370, 0x03FF, kScriptGreek },
+  { 0x0400, 0x052F, kScriptCyrillic },
+  { 0x0531, 0x058F, kScriptArmenian },
+  { 0x0591, 0x05FF, kScriptHebrew },
+  { 0x0600, 0x06FF, kScriptArabic },
+  { 0x0750, 0x077F, kScriptArabic },
+  { 0x08A0, 0x08FF, kScriptArabic },
+  { 0x0900, 0x097F, kScriptDevanagari },
+  { 0x0980, 0x09FF, kScriptBengali },
+  { 0x0A00, 0x0A7F, kScriptGurmukhi },
+  { 0x0A80, 0x0AFF, kScriptGujarati },
+  { 0x0B00, 0x0B7F, kScriptOriya },
+  { 0x0B80, 0x0BFF, kScriptTamil },
+  { 0x0C00, 0x0C7F, kScriptTelugu },
+  { 0x0C80, 0x0CFF, kScriptKannada },
+  { 0x0D00, 0x0D7F, kScriptMalayalam },
+  { 0x0D80, 0x0DFF, kScriptSinhala },
+  { 0x0E00, 0x0E7F, kScriptThai },
+  { 0x0E80, 0x0EFF, kScriptLao },
+  { 0x0F00, 0x0FFF, kScriptTibetan },
+  { 0x1000, 0x109F, kScriptMyanmar },
+  { 0x10A0, 0x10FF, kScriptGeorgian },
+  { 0x1100, 0x11FF, kScriptHangul },
+  { 0x1200, 0x139F, kScriptEthiopic },
+  { 0x1780, 0x17FF, kScriptKhmer },
+  { 0x1800, 0x18AF, kScriptMongolian },
+  { 0x1E00, 0x1EFF, kScriptLatin },
+  { 0x1F00, 0x1FFF, kScriptGreek },
+  { 0x2C60, 0x2C7F, kScriptLatin },
+  { 0x2D00, 0x2D2F, kScriptGeorgian },
+  { 0x2D80, 0x2DDF, kScriptEthiopic },
+  { 0x2DE0, 0x2DFF, kScriptCyrillic },
+  { 0x2E80, 0x2FDF, kScriptHan },
+  { 0x3041, 0x30FF, kScriptKana },
+  { 0x3131, 0x318E, kScriptHangul },
+  { 0x31F0, 0x31FF, kScriptKana },
+  { 0x3400, 0x4DBF, kScriptHan },
+  { 0x4E00, 0x9FFF, kScriptHan },
+  { 0xA000, 0xA4CF, kScriptYi },
+  { 0xA640, 0xA69F, kScriptCyrillic },
+  { 0xA720, 0xA7FF, kScriptLatin },
+  { 0xA960, 0xA97F, kScriptHangul },
+  { 0xAC00, 0xD7FF, kScriptHangul },
+  { 0xD840, 0xD87E, kScriptHan },  // high surrogates of the planes 2 and 3
+  { 0xF900, 0xFAFF, kScriptHan },
+  { 0xFB00, 0xFB06, kScriptLatin },
+  { 0xFB1D, 0xFB4F, kScriptHebrew },
+  { 0xFB50, 0xFDFF, kScriptArabic },
+  { 0xFE70, 0xFEFF, kScriptArabic },
+  { 0xFF21, 0xFF3A, kScriptLatin },
+  { 0xFF41, 0xFF5A, kScriptLatin },
+  { 0xFF66, 0xFF9F, kScriptKana },
+  { 0xFFA0, 0xFFDC, kScriptHangul },
+};
+
+const size_t kScriptRangeCount = sizeof(kScriptRanges) / sizeof(kScriptRanges[0]);
+
+// The scripts of the upper halves of the 8-bit encodings not for the Latin
+// alphabet, by the names of csutil.cxx without the punctuation.
+const struct {
+  const char *encoding;
+  Script script;
+} kEncodingScripts[] = {
+  { "iso88595", kScriptCyrillic },
+  { "koi8r", kScriptCyrillic },
+  { "koi8u", kScriptCyrillic },
+  { "cp1251", kScriptCyrillic },
+  { "microsoftcp1251", kScriptCyrillic },
+  { "iso88596", kScriptArabic },
+  { "iso88597", kScriptGreek },
+  { "iso88598", kScriptHebrew },
+  { "tis620", kScriptThai },
+  { "tis6202533", kScriptThai },
+  { "iso885911", kScriptThai },
+  { "xisciias", kScriptDevanagari },
+  { "isciidevanagari", kScriptDevanagari },
+};
+
+Script GetEncodingScript(const char *encoding) {
+  char name[32];
+  size_t length = 0;
+  for (const char *p = encoding; *p && length < sizeof(name) - 1; ++p) {
+    if (isalnum((unsigned char)*p)) {
+      name[length++] = tolower((unsigned char)*p);
+    }
+  }
+  name[length] = '\0';
+
+  for (size_t i = 0; i < sizeof(kEncodingScripts) / sizeof(kEncodingScripts[0]); ++i) {
+    if (strcmp(name, kEncodingScripts[i].encoding) == 0) {
+      return kEncodingScripts[i].script;
+    }
+  }
+  return kScriptLatin;
+}
+
+}  // namespace
+
+ScriptTable::ScriptTable() : last(0) { }
+
+Script ScriptTable::GetScript(uint16_t c) {
+  if (c < 0x80) {
+    return ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') ? kScriptLatin : kScriptUnknown;
+  }
+
+  if (c >= kScriptRanges[last].first && c <= kScriptRanges[last].last) {
+    return kScriptRanges[last].script;
+  }
+
+  size_t low = 0, high = kScriptRangeCount;
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    if (c > kScriptRanges[middle].last) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  if (low == kScriptRangeCount || c < kScriptRanges[low].first) {
+    return kScriptUnknown;
+  }
+  last = low;
+  return kScriptRanges[low].script;
+}
+
+uint32_t ScriptTable::GetScripts(const char *text, const char *encoding) {
+  uint32_t scripts = 0;
+  if (!text) {
+    return scripts;
+  }
+
+  bool utf8 = encoding && strcmp(encoding, "UTF-8") == 0;
+  Script upper = utf8 ? kScriptUnknown : GetEncodingScript(encoding ? encoding : "");
+  ScriptTable table;
+
+  for (const unsigned char *p = (const unsigned char *)text; *p; ) {
+    uint32_t c = *p++;
+    if (c >= 0x80 && !utf8) {
+      scripts |= 1 << upper;
+      continue;
+    }
+
+    // NB: Only the BMP, as the table
+    if (c >= 0xE0 && c < 0xF0 && (p[0] & 0xC0) == 0x80 && (p[1] & 0xC0) == 0x80) {
+      c = ((c & 0x0F) << 12) | ((p[0] & 0x3F) << 6) | (p[1] & 0x3F);
+      p += 2;
+    } else if (c >= 0xC0 && c < 0xE0 && (p[0] & 0xC0) == 0x80) {
+      c = ((c & 0x1F) << 6) | (p[0] & 0x3F);
+      p += 1;
+    } else if (c >= 0x80) {
+      continue;
+    }
+
+    Script script = table.GetScript((uint16_t)c);
+    if (script != kScriptUnknown) {
+      scripts |= 1 << script;
+    }
+  }
+  return scripts;
+}
+
+}  // namespace spellchecker
@@ -0,0 +1,62 @@
+#ifndef SRC_SCRIPT_TABLE_H_
+#define SRC_SCRIPT_TABLE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace spellchecker {
+
+// The writing systems of the letters, to skip the words a dictionary can't
+// contain. Sets of them are bit masks, 1 << script.
+enum Script {
+  kScriptUnknown,
+  kScriptLatin,
+  kScriptGreek,
+  kScriptCyrillic,
+  kScriptArmenian,
+  kScriptHebrew,
+  kScriptArabic,
+  kScriptDevanagari,
+  kScriptBengali,
+  kScriptGurmukhi,
+  kScriptGujarati,
+  kScriptOriya,
+  kScriptTamil,
+  kScriptTelugu,
+  kScriptKannada,
+  kScriptMalayalam,
+  kScriptSinhala,
+  kScriptThai,
+  kScriptLao,
+  kScriptTibetan,
+  kScriptMyanmar,
+  kScriptGeorgian,
+  kScriptHangul,
+  kScriptEthiopic,
+  kScriptKhmer,
+  kScriptMongolian,
+  kScriptKana,
+  kScriptHan,
+  kScriptYi,
+};
+
+class ScriptTable {
+public:
+  ScriptTable();
+
+  // Returns the script of a UTF-16 code unit, kScriptUnknown for the
+  // characters of no (or more than one) script. NB: Remembers the last range
+  // found, as the letters of a run are mostly from the same block.
+  Script GetScript(uint16_t c);
+
+  // Returns the scripts of the letters of a string in a dictionary encoding
+  // (the SET of an affix file).
+  static uint32_t GetScripts(const char *text, const char *encoding);
+
+private:
+  size_t last;
+};
+
+}  // namespace spellchecker
+
+#endif  // SRC_SCRIPT_TABLE_H_
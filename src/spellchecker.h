@@ -12,22 +12,145 @@ struct MisspelledRange {
   size_t end;
 };
 
+// Options of loading a dictionary (only used by Hunspell).
+struct DictionaryOptions {
+  // Keep the words in a minimal automaton: several times less memory, but
+  // slower suggestions for words with no close correction.
+  bool compressed;
+
+  // File of the suggestions computed beforehand by WriteSuggestionFile, by
+  // default lang.sug next to the dictionary.
+  std::string suggestionFile;
+
+  // Measure the phases of the loading, see GetLoadProfile.
+  bool profile;
+
+  DictionaryOptions() : compressed(false), profile(false) {}
+};
+
+// Work of a phase of loading a dictionary, see GetLoadProfile. The nested
+// phases aren't included.
+struct LoadPhaseProfile {
+  std::string phase;
+  double milliseconds;
+  uint64_t calls;
+  uint64_t allocations;  // Not counting the frees
+  uint64_t bytes;
+};
+
+// Work of a generator of corrections, see TakeSuggestionStats.
+struct SuggestionStat {
+  std::string generator;
+  uint64_t tried;  // Candidates looked up in the dictionary
+  uint64_t found;  // Corrections found
+};
+
+// What the dictionary knows about a checked word, see CheckWords.
+struct WordInfo {
+  enum Flags {
+    kCompound = 1 << 0,   // Accepted as a compound of dictionary words
+    kForbidden = 1 << 1,  // Explicitly forbidden by the dictionary
+    kWarn = 1 << 2,       // Has the WARN flag of the dictionary (rare words)
+    kCustom = 1 << 3      // Added or removed with Add and Remove
+  };
+
+  bool misspelled;
+  uint8_t flags;
+
+  // The dictionary word of an affixed or compound word, if asked for
+  std::string root;
+
+  WordInfo() : misspelled(false), flags(0) {}
+};
+
+// Words CheckSpelling doesn't check, nothing by default.
+struct TokenFilter {
+  // Words without lowercase letters, like acronyms
+  bool ignoreAllCaps;
+
+  // Words with an uppercase letter after a lowercase one, like identifiers
+  bool ignoreMixedCase;
+
+  // Words with digits, like product codes. NB: Hunspell never checks them.
+  bool ignoreWordsWithDigits;
+
+  // Limits of the length of the checked words in UTF-16 characters, 0 for
+  // none
+  size_t minLength;
+  size_t maxLength;
+
+  TokenFilter() : ignoreAllCaps(false), ignoreMixedCase(false), ignoreWordsWithDigits(false),
+    minLength(0), maxLength(0) {}
+
+  // Returns true if the word isn't checked.
+  bool Skips(const uint16_t *word, size_t length) const;
+
+  // Removes the ranges of the words which aren't checked.
+  void Apply(const uint16_t *text, std::vector<MisspelledRange>& ranges) const;
+};
+
 class SpellcheckerImplementation {
 public:
-  virtual bool SetDictionary(const std::string& language, const std::string& path) = 0;
+  virtual bool SetDictionary(const std::string& language, const std::string& path,
+                             const DictionaryOptions& options) = 0;
   virtual std::vector<std::string> GetAvailableDictionaries(const std::string& path) = 0;
 
+  // Loads a Hunspell dictionary from the contents of its .aff and .dic files.
+  // Returns false if the implementation can't use Hunspell dictionaries.
+  virtual bool SetDictionaryFromBuffers(const char* affData, size_t affSize,
+                                        const char* dicData, size_t dicSize,
+                                        const DictionaryOptions& options) = 0;
+
   // Returns an array containing possible corrections for the word.
   virtual std::vector<std::string> GetCorrectionsForMisspelling(const std::string& word) = 0;
 
+  // Computes the corrections of the misspellings into a file, which is used
+  // by GetCorrectionsForMisspelling with this dictionary from then on (empty
+  // path for the default one of the dictionary). Returns false if the
+  // implementation can't use Hunspell dictionaries.
+  virtual bool WriteSuggestionFile(const std::string& path,
+                                   const std::vector<std::string>& misspellings) = 0;
+
+  // Returns the work of the generators of GetCorrectionsForMisspelling since
+  // the previous call, for benchmarks. Empty if the implementation doesn't
+  // know it.
+  virtual std::vector<SuggestionStat> TakeSuggestionStats() = 0;
+
+  // Returns the phases of the last load of a dictionary with the profile
+  // option. Empty without it, or if the implementation doesn't load
+  // dictionaries.
+  virtual std::vector<LoadPhaseProfile> GetLoadProfile() = 0;
+
+  // Returns the correction of a typical misspelling, or an empty string when
+  // there isn't exactly one. Cheap enough to call while the user types.
+  virtual std::string GetAutocorrection(const std::string& word) = 0;
+
+  // Returns up to limit dictionary words starting with the prefix, allowing
+  // maxEdits typing errors in the prefix.
+  virtual std::vector<std::string> GetCompletions(const std::string& prefix, int limit, int maxEdits) = 0;
+
   // Returns true if the word is misspelled.
   virtual bool IsMisspelled(const std::string& word) = 0;
 
+  // Checks the words with one lookup per word. The flags (and the roots,
+  // with withRoots) are only known with Hunspell.
+  virtual std::vector<WordInfo> CheckWords(const std::vector<std::string>& words, bool withRoots) = 0;
+
   virtual std::vector<MisspelledRange> CheckSpelling(const uint16_t *text, size_t length) = 0;
 
+  // Returns true if the implementation may be used on other threads than the
+  // one which created it, one call at a time. The OS spellcheckers are bound
+  // to the main thread.
+  virtual bool CanCheckOnAnyThread() = 0;
+
+  // Sets the words CheckSpelling doesn't check.
+  virtual void SetTokenFilter(const TokenFilter& filter) = 0;
+
   // Adds a new word to the dictionary.
   // NB: When using Hunspell, this will not modify the .dic file; custom words must be added each
   // time the spellchecker is created. Use a custom dictionary file.
+  // NB: Add and Remove are called on the main thread without the lock, so with
+  // CanCheckOnAnyThread they must be safe during a check on another thread.
   virtual void Add(const std::string& word) = 0;
   
   // Removes a word from the custom dictionary added by Add.
@@ -1,12 +1,42 @@
 #include <cstdio>
-#include <cwctype>
+#include <cstdlib>
+#include <cstring>
 #include <algorithm>
 #include "../vendor/hunspell/src/hunspell/hunspell.hxx"
 #include "spellchecker_hunspell.h"
+#include "script_table.h"
+#include "word_iterator.h"
 
 namespace spellchecker {
 
-HunspellSpellchecker::HunspellSpellchecker() : hunspell(NULL), transcoder(NewTranscoder()) { }
+// A snapshot of the custom words, as Hunspell sees them: its lookups apply
+// the dictionary rules to them (capitalized forms, affixes of the removed
+// words)
+class CustomWordOverlay : public WordOverlay {
+public:
+  explicit CustomWordOverlay(const std::shared_ptr<const CustomWords::Snapshot>& snapshot)
+    : snapshot(snapshot) { }
+
+  int find(const char* word) const {
+    switch (CustomWords::Lookup(*snapshot, word)) {
+      case CustomWords::kAdded:
+        return OVERLAY_ADDED;
+      case CustomWords::kRemoved:
+        return OVERLAY_REMOVED;
+      default:
+        return 0;
+    }
+  }
+
+  void get_added(std::vector<const char*>& words) const {
+    CustomWords::GetAdded(*snapshot, words);
+  }
+
+  const std::shared_ptr<const CustomWords::Snapshot> snapshot;
+};
+
+HunspellSpellchecker::HunspellSpellchecker() : hunspell(NULL), transcoder(NewTranscoder()),
+  bufferFingerprint(0), scripts(0) { }
 
 HunspellSpellchecker::~HunspellSpellchecker() {
   if (hunspell) {
@@ -18,7 +48,8 @@ HunspellSpellchecker::~HunspellSpellchecker() {
   }
 }
 
-bool HunspellSpellchecker::SetDictionary(const std::string& language, const std::string& dirname) {
+bool HunspellSpellchecker::SetDictionary(const std::string& language, const std::string& dirname,
+                                         const DictionaryOptions& options) {
   if (hunspell) {
     delete hunspell;
     hunspell = NULL;
@@ -39,10 +70,81 @@ bool HunspellSpellchecker::SetDictionary(const std::string& language, const std:
   }
   fclose(handle);
 
-  hunspell = new Hunspell(affixpath.c_str(), dpath.c_str());
+  hunspell = new Hunspell(affixpath.c_str(), dpath.c_str(), NULL, GetLoadOptions(options));
+  LoadScripts();
+  customWords.Clear();
+  overlay.reset();
+
+  affixPath = affixpath;
+  dicPath = dpath;
+  suggestionPath = options.suggestionFile.empty() ? dirname + "/" + lang + ".sug" : options.suggestionFile;
+
+  // NB: Only fingerprints the dictionary if there are suggestions for it
+  suggestionFile.Close();
+  handle = fopen(suggestionPath.c_str(), "rb");
+  if (handle) {
+    fclose(handle);
+    suggestionFile.Open(suggestionPath, GetFingerprint());
+  }
+  return true;
+}
+
+bool HunspellSpellchecker::SetDictionaryFromBuffers(const char* affData, size_t affSize,
+                                                    const char* dicData, size_t dicSize,
+                                                    const DictionaryOptions& options) {
+  if (hunspell) {
+    delete hunspell;
+    hunspell = NULL;
+  }
+
+  hunspell = new Hunspell(affData, affSize, dicData, dicSize, GetLoadOptions(options));
+  LoadScripts();
+  customWords.Clear();
+  overlay.reset();
+
+  affixPath.clear();
+  dicPath.clear();
+  bufferFingerprint = SuggestionFile::Fingerprint(SuggestionFile::Fingerprint(0, affData, affSize),
+                                                  dicData, dicSize);
+  suggestionPath = options.suggestionFile;
+
+  suggestionFile.Close();
+  if (!suggestionPath.empty()) {
+    suggestionFile.Open(suggestionPath, bufferFingerprint);
+  }
   return true;
 }
 
+uint64_t HunspellSpellchecker::GetFingerprint() {
+  if (dicPath.empty()) {
+    return bufferFingerprint;
+  }
+  return SuggestionFile::FingerprintFile(SuggestionFile::FingerprintFile(0, affixPath), dicPath);
+}
+
+int HunspellSpellchecker::GetLoadOptions(const DictionaryOptions& options) {
+  // NB: The morphological analysis isn't exposed, so only the ph: fields of
+  // the dictionary words are loaded
+  int loadOptions = HUNSPELL_LOAD_NOMORPH;
+  if (options.compressed) {
+    loadOptions |= HUNSPELL_LOAD_COMPRESSED;
+  }
+  if (options.profile) {
+    loadOptions |= HUNSPELL_LOAD_PROFILE;
+  }
+  return loadOptions;
+}
+
+// NB: TRY lists the letters of the language for the suggestions, so words
+// of the other scripts can't be in the dictionary
+void HunspellSpellchecker::LoadScripts() {
+  const char* encoding = hunspell->get_dic_encoding();
+  char* trystring = hunspell->get_try_string();
+  scripts = ScriptTable::GetScripts(trystring, encoding) |
+    ScriptTable::GetScripts(hunspell->get_wordchars(), encoding);
+  free(trystring);
+}
+
 std::vector<std::string> HunspellSpellchecker::GetAvailableDictionaries(const std::string& path) {
   return std::vector<std::string>();
 }
@@ -51,83 +153,202 @@ bool HunspellSpellchecker::IsMisspelled(const std::string& word) {
   if (!hunspell) {
     return false;
   }
+  UseCustomWords();
   return hunspell->spell(word.c_str()) == 0;
 }
 
+// Shows Hunspell the current snapshot of the custom words. NB: Called at the
+// start of each call using hunspell, so a call sees one snapshot, and Add
+// and Remove don't wait for the calls.
+void HunspellSpellchecker::UseCustomWords() {
+  std::shared_ptr<const CustomWords::Snapshot> snapshot = customWords.Get();
+  if (overlay ? overlay->snapshot == snapshot : CustomWords::IsEmpty(*snapshot)) {
+    return;
+  }
+
+  if (CustomWords::IsEmpty(*snapshot)) {
+    overlay.reset();
+  } else {
+    overlay = std::make_shared<CustomWordOverlay>(snapshot);
+  }
+  hunspell->set_overlay(overlay.get());
+}
+
+// Returns 1 if the word is an added word, -1 if it is a removed word, 0
+// otherwise. As with Hunspell, the capitalized and uppercase forms of a word
+// count as it.
+int HunspellSpellchecker::LookupCustomWord(const std::string& word) {
+  if (!overlay) {
+    return 0;
+  }
+
+  const CustomWords::Snapshot& custom = *overlay->snapshot;
+  int found = CustomWords::Lookup(custom, word.c_str());
+  char** variants;
+  int size = found ? 0 : hunspell->case_variants(&variants, word.c_str());
+  for (int i = 0; i < size && !found; ++i) {
+    found = CustomWords::Lookup(custom, variants[i]);
+  }
+  if (size > 0) {
+    hunspell->free_list(&variants, size);
+  }
+  return found;
+}
+
+// NB: Hunspell's info bits are internal (atypes.hxx), so they're translated
+static uint8_t ToWordFlags(int info) {
+  uint8_t flags = 0;
+  if (info & SPELL_COMPOUND) {
+    flags |= WordInfo::kCompound;
+  }
+  if (info & SPELL_FORBIDDEN) {
+    flags |= WordInfo::kForbidden;
+  }
+  if (info & SPELL_WARN) {
+    flags |= WordInfo::kWarn;
+  }
+  return flags;
+}
+
+// NB: Every word is looked up in the dictionary, the custom words included:
+// Hunspell applies them through the overlay (see UseCustomWords), with the
+// same case rules as its own words. CUSTOM only marks the words added or
+// removed, in any of their case forms.
+std::vector<WordInfo> HunspellSpellchecker::CheckWords(const std::vector<std::string>& words, bool withRoots) {
+  std::vector<WordInfo> result(words.size());
+  if (!hunspell) {
+    return result;
+  }
+  UseCustomWords();
+
+  for (size_t i = 0; i < words.size(); ++i) {
+    WordInfo& word = result[i];
+    int info = 0;
+    char* root = NULL;
+    word.misspelled = hunspell->spell(words[i].c_str(), &info, withRoots ? &root : NULL) == 0;
+    word.flags = ToWordFlags(info);
+    if (LookupCustomWord(words[i]) != 0) {
+      word.flags |= WordInfo::kCustom;
+    }
+    if (root) {
+      word.root = root;
+      free(root);
+    }
+  }
+  return result;
+}
+
+// Whether a word has a letter of a script the dictionary doesn't contain, so
+// it can be skipped
+static bool IsUncovered(ScriptTable& table, uint32_t scripts, const uint16_t *word, size_t length) {
+  if (!scripts) {
+    return false;
+  }
+
+  for (size_t i = 0; i < length; ++i) {
+    Script script = table.GetScript(word[i]);
+    if (script != kScriptUnknown && !(scripts & (1 << script))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool HunspellSpellchecker::CanCheckOnAnyThread() {
+  return true;
+}
+
 std::vector<MisspelledRange> HunspellSpellchecker::CheckSpelling(const uint16_t *utf16_text, size_t utf16_length) {
   std::vector<MisspelledRange> result;
 
   if (!hunspell || !transcoder) {
     return result;
   }
+  UseCustomWords();
 
   std::vector<char> utf8_buffer(256);
+  ScriptTable table;
+  WordIterator words(utf16_text, utf16_length);
+
+  size_t start, end;
+  while (words.Next(&start, &end)) {
+    if (IsUncovered(table, scripts, utf16_text + start, end - start) ||
+        filter.Skips(utf16_text + start, end - start)) {
+      continue;
+    }
 
-  enum {
-    unknown,
-    in_separator,
-    in_word,
-  } state = in_separator;
-
-  for (size_t word_start = 0, i = 0; i < utf16_length; i++) {
-    uint16_t c = utf16_text[i];
-
-    switch (state) {
-      case unknown:
-        if (iswpunct(c) || iswspace(c)) {
-          state = in_separator;
-        }
-        break;
-
-      case in_separator:
-        if (iswalpha(c)) {
-          word_start = i;
-          state = in_word;
-        } else if (!iswpunct(c) && !iswspace(c)) {
-          state = unknown;
-        }
-        break;
-
-      case in_word:
-        if (c == '\'' && iswalpha(utf16_text[i + 1])) {
-          i++;
-        } else if (c == 0 || iswpunct(c) || iswspace(c)) {
-          state = in_separator;
-          bool converted = TranscodeUTF16ToUTF8(transcoder, (char *)utf8_buffer.data(), utf8_buffer.size(), utf16_text + word_start, i - word_start);
-          if (converted) {
-            if (hunspell->spell(utf8_buffer.data()) == 0) {
-              MisspelledRange range;
-              range.start = word_start;
-              range.end = i;
-              result.push_back(range);
-            }
-          }
-        } else if (!iswalpha(c)) {
-          state = unknown;
-        }
-        break;
+    bool converted = TranscodeUTF16ToUTF8(transcoder, (char *)utf8_buffer.data(), utf8_buffer.size(), utf16_text + start, end - start);
+    if (converted) {
+      if (hunspell->spell(utf8_buffer.data()) == 0) {
+        MisspelledRange range;
+        range.start = start;
+        range.end = end;
+        result.push_back(range);
+      }
     }
   }
 
   return result;
 }
 
+void HunspellSpellchecker::SetTokenFilter(const TokenFilter& filter) {
+  this->filter = filter;
+}
+
+// NB: Only publishes a new snapshot of the custom words, which the calls
+// starting afterwards use (see UseCustomWords). Hunspell treats the removed
+// words as FORBIDDENWORD, so their affixed and capitalized forms are rejected
+// too.
 void HunspellSpellchecker::Add(const std::string& word) {
-  if (hunspell) {
-    hunspell->add(word.c_str());
-  }
+  customWords.Add(word);
 }
 
 void HunspellSpellchecker::Remove(const std::string& word) {
-  if (hunspell) {
-    hunspell->remove(word.c_str());
+  customWords.Remove(word);
+}
+
+// Whether the word is a removed word or one of its forms, which Hunspell
+// reports as forbidden
+bool HunspellSpellchecker::IsRemovedForm(const char* word) {
+  if (!overlay || !overlay->snapshot->removed) {
+    return false;
+  }
+
+  int info = 0;
+  return hunspell->spell(word, &info, NULL) == 0 && (info & SPELL_FORBIDDEN);
+}
+
+// Puts the added words first in corrections or completions, and drops the
+// forms of the removed words (e.g. from the suggestion file)
+std::vector<std::string> HunspellSpellchecker::MergeCustomWords(const std::vector<std::string>& added,
+                                                                const std::vector<std::string>& words) {
+  std::vector<std::string> result(added);
+  for (size_t i = 0; i < words.size(); ++i) {
+    if (std::find(added.begin(), added.end(), words[i]) == added.end() &&
+        !IsRemovedForm(words[i].c_str())) {
+      result.push_back(words[i]);
+    }
   }
+  return result;
 }
 
 std::vector<std::string> HunspellSpellchecker::GetCorrectionsForMisspelling(const std::string& word) {
+  if (!hunspell) {
+    return std::vector<std::string>();
+  }
+  UseCustomWords();
+
+  std::vector<std::string> added;
+  if (overlay) {
+    added = CustomWords::FindNear(*overlay->snapshot, word, kMaxCustomDistance);
+  }
+  return MergeCustomWords(added, GetDictionaryCorrections(word));
+}
+
+std::vector<std::string> HunspellSpellchecker::GetDictionaryCorrections(const std::string& word) {
   std::vector<std::string> corrections;
 
-  if (hunspell) {
+  if (!suggestionFile.Find(word, corrections)) {
     char** slist;
     int size = hunspell->suggest(&slist, word.c_str());
 
@@ -141,4 +362,131 @@ std::vector<std::string> HunspellSpellchecker::GetCorrectionsForMisspelling(cons
   return corrections;
 }
 
+bool HunspellSpellchecker::WriteSuggestionFile(const std::string& path,
+                                               const std::vector<std::string>& misspellings) {
+  std::string file = path.empty() ? suggestionPath : path;
+  if (!hunspell || file.empty()) {
+    return false;
+  }
+  UseCustomWords();
+
+  std::vector<std::string> words(misspellings);
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+
+  // NB: Closed first, so the engine computes the suggestions
+  suggestionFile.Close();
+
+  std::vector<std::vector<std::string> > suggestions(words.size());
+  for (size_t i = 0; i < words.size(); ++i) {
+    suggestions[i] = GetDictionaryCorrections(words[i]);
+  }
+
+  uint64_t fingerprint = GetFingerprint();
+  if (!SuggestionFile::Write(file, fingerprint, words, suggestions)) {
+    return false;
+  }
+  suggestionPath = file;
+  return suggestionFile.Open(file, fingerprint);
+}
+
+std::vector<SuggestionStat> HunspellSpellchecker::TakeSuggestionStats() {
+  std::vector<SuggestionStat> result;
+  const struct sugstat* stats = hunspell ? hunspell->get_suggest_stats() : NULL;
+  if (!stats) {
+    return result;
+  }
+
+  for (int i = 0; i < SUG_GENERATORS; ++i) {
+    SuggestionStat stat;
+    stat.generator = SuggestMgr::get_generator_name(i);
+    stat.tried = stats[i].tried;
+    stat.found = stats[i].found;
+    result.push_back(stat);
+  }
+
+  hunspell->reset_suggest_stats();
+  return result;
+}
+
+std::vector<LoadPhaseProfile> HunspellSpellchecker::GetLoadProfile() {
+  std::vector<LoadPhaseProfile> result;
+  const struct loadprof* profile = hunspell ? hunspell->get_load_profile() : NULL;
+  if (!profile) {
+    return result;
+  }
+
+  for (int i = 0; i < LOAD_PHASES; ++i) {
+    const struct loadphase& phase = profile->phase[i];
+    if (phase.calls == 0) {
+      continue;
+    }
+
+    LoadPhaseProfile stat;
+    stat.phase = loadprof_name(i);
+    stat.milliseconds = phase.ms;
+    stat.calls = phase.calls;
+    stat.allocations = phase.allocs;
+    stat.bytes = phase.bytes;
+    result.push_back(stat);
+  }
+  return result;
+}
+
+std::string HunspellSpellchecker::GetAutocorrection(const std::string& word) {
+  std::string correction;
+  if (!hunspell) {
+    return correction;
+  }
+  UseCustomWords();
+
+  if (LookupCustomWord(word) <= 0) {
+    char* dest;
+    if (hunspell->autocorrect(&dest, word.c_str()) > 0) {
+      if (!IsRemovedForm(dest)) {
+        correction = dest;
+      }
+      free(dest);
+    }
+  }
+  return correction;
+}
+
+std::vector<std::string> HunspellSpellchecker::GetCompletions(const std::string& prefix, int limit, int maxEdits) {
+  std::vector<std::string> completions;
+
+  if (hunspell) {
+    UseCustomWords();
+
+    char** slist;
+    int size = hunspell->complete(&slist, prefix.c_str(), maxEdits, limit);
+
+    completions.reserve(size);
+    for (int i = 0; i < size; ++i) {
+      completions.push_back(slist[i]);
+    }
+
+    hunspell->free_list(&slist, size);
+
+    // The added words starting with the prefix come first
+    std::vector<const char*> words;
+    if (overlay) {
+      CustomWords::GetAdded(*overlay->snapshot, words);
+    }
+    std::vector<std::string> added;
+    for (size_t i = 0; i < words.size(); ++i) {
+      if (strncmp(words[i], prefix.c_str(), prefix.size()) == 0 && strlen(words[i]) > prefix.size()) {
+        added.push_back(words[i]);
+      }
+    }
+    std::sort(added.begin(), added.end());
+
+    completions = MergeCustomWords(added, completions);
+    if (limit >= 0 && completions.size() > (size_t)limit) {
+      completions.resize(limit);
+    }
+  }
+  return completions;
+}
+
 }  // namespace spellchecker
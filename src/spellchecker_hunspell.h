@@ -3,27 +3,74 @@
 
 #include "spellchecker.h"
 #include "transcoder.h"
+#include "suggestion_file.h"
+#include "custom_words.h"
 
 class Hunspell;
 
 namespace spellchecker {
 
+class CustomWordOverlay;
+
 class HunspellSpellchecker : public SpellcheckerImplementation {
 public:
   HunspellSpellchecker();
   ~HunspellSpellchecker();
 
-  bool SetDictionary(const std::string& language, const std::string& path);
+  bool SetDictionary(const std::string& language, const std::string& path,
+                     const DictionaryOptions& options);
   std::vector<std::string> GetAvailableDictionaries(const std::string& path);
+  bool SetDictionaryFromBuffers(const char* affData, size_t affSize,
+                                const char* dicData, size_t dicSize,
+                                const DictionaryOptions& options);
   std::vector<std::string> GetCorrectionsForMisspelling(const std::string& word);
+  bool WriteSuggestionFile(const std::string& path, const std::vector<std::string>& misspellings);
+  std::vector<SuggestionStat> TakeSuggestionStats();
+  std::vector<LoadPhaseProfile> GetLoadProfile();
+  std::string GetAutocorrection(const std::string& word);
+  std::vector<std::string> GetCompletions(const std::string& prefix, int limit, int maxEdits);
   bool IsMisspelled(const std::string& word);
+  std::vector<WordInfo> CheckWords(const std::vector<std::string>& words, bool withRoots);
   std::vector<MisspelledRange> CheckSpelling(const uint16_t *text, size_t length);
+  bool CanCheckOnAnyThread();
+  void SetTokenFilter(const TokenFilter& filter);
   void Add(const std::string& word);
   void Remove(const std::string& word);
 
 private:
+  // Edits between a misspelling and the added words suggested for it
+  static const size_t kMaxCustomDistance = 2;
+
+  static int GetLoadOptions(const DictionaryOptions& options);
+  std::vector<std::string> GetDictionaryCorrections(const std::string& word);
+  void UseCustomWords();
+  int LookupCustomWord(const std::string& word);
+  bool IsRemovedForm(const char* word);
+  std::vector<std::string> MergeCustomWords(const std::vector<std::string>& added,
+                                            const std::vector<std::string>& words);
+  void LoadScripts();
+  uint64_t GetFingerprint();
+
   Hunspell* hunspell;
   Transcoder *transcoder;
+  TokenFilter filter;
+
+  // The files of the dictionary, or the fingerprint of its buffers
+  std::string affixPath;
+  std::string dicPath;
+  uint64_t bufferFingerprint;
+
+  SuggestionFile suggestionFile;
+  std::string suggestionPath;
+
+  // Added and removed words, on top of the dictionary, and the snapshot of
+  // them Hunspell uses (see UseCustomWords)
+  CustomWords customWords;
+  std::shared_ptr<CustomWordOverlay> overlay;
+
+  // The scripts of the dictionary letters (from TRY and WORDCHARS), 0 when
+  // unknown
+  uint32_t scripts;
 };
 
 }  // namespace spellchecker
@@ -18,7 +18,8 @@ MacSpellchecker::~MacSpellchecker() {
   this->spellCheckerLanguage = nil;
 }
 
-bool MacSpellchecker::SetDictionary(const std::string& language, const std::string& path) {
+bool MacSpellchecker::SetDictionary(const std::string& language, const std::string& path,
+                                    const DictionaryOptions& options) {
   @autoreleasepool {
     [this->spellCheckerLanguage release];
 
@@ -34,6 +35,26 @@ bool MacSpellchecker::SetDictionary(const std::string& language, const std::stri
   }
 }
 
+bool MacSpellchecker::SetDictionaryFromBuffers(const char* affData, size_t affSize,
+                                               const char* dicData, size_t dicSize,
+                                               const DictionaryOptions& options) {
+  // NB: NSSpellChecker can't load Hunspell dictionaries
+  return false;
+}
+
+bool MacSpellchecker::WriteSuggestionFile(const std::string& path,
+                                          const std::vector<std::string>& misspellings) {
+  return false;
+}
+
+std::vector<SuggestionStat> MacSpellchecker::TakeSuggestionStats() {
+  return std::vector<SuggestionStat>();
+}
+
+std::vector<LoadPhaseProfile> MacSpellchecker::GetLoadProfile() {
+  return std::vector<LoadPhaseProfile>();
+}
+
 std::vector<std::string> MacSpellchecker::GetAvailableDictionaries(const std::string& path) {
   std::vector<std::string> ret;
 
@@ -64,6 +85,18 @@ bool MacSpellchecker::IsMisspelled(const std::string& word) {
   return result;
 }
 
+std::vector<WordInfo> MacSpellchecker::CheckWords(const std::vector<std::string>& words, bool withRoots) {
+  std::vector<WordInfo> result(words.size());
+  for (size_t i = 0; i < words.size(); ++i) {
+    result[i].misspelled = this->IsMisspelled(words[i]);
+  }
+  return result;
+}
+
+bool MacSpellchecker::CanCheckOnAnyThread() {
+  return false;
+}
+
 std::vector<MisspelledRange> MacSpellchecker::CheckSpelling(const uint16_t *text, size_t length) {
   std::vector<MisspelledRange> result;
 
@@ -87,9 +120,14 @@ std::vector<MisspelledRange> MacSpellchecker::CheckSpelling(const uint16_t *text
     }
   }
 
+  filter.Apply(text, result);
   return result;
 }
 
+void MacSpellchecker::SetTokenFilter(const TokenFilter& filter) {
+  this->filter = filter;
+}
+
 void MacSpellchecker::Add(const std::string& word) {
   @autoreleasepool {
     this->UpdateGlobalSpellchecker();
@@ -136,6 +174,58 @@ std::vector<std::string> MacSpellchecker::GetCorrectionsForMisspelling(const std
   return corrections;
 }
 
+std::string MacSpellchecker::GetAutocorrection(const std::string& word) {
+  std::string correction;
+
+  @autoreleasepool {
+    this->UpdateGlobalSpellchecker();
+
+    NSString* misspelling = [NSString stringWithUTF8String:word.c_str()];
+    NSString* language = [this->spellChecker language];
+    NSRange range;
+
+    range.location = 0;
+    range.length = [misspelling length];
+
+    NSString* replacement = [this->spellChecker correctionForWordRange:range
+                                                              inString:misspelling
+                                                              language:language
+                                                inSpellDocumentWithTag:0];
+    if (replacement) {
+      correction = [replacement UTF8String];
+    }
+  }
+
+  return correction;
+}
+
+std::vector<std::string> MacSpellchecker::GetCompletions(const std::string& prefix, int limit, int maxEdits) {
+  std::vector<std::string> completions;
+
+  // NB: NSSpellChecker only completes exact prefixes, maxEdits is ignored
+  @autoreleasepool {
+    this->UpdateGlobalSpellchecker();
+
+    NSString* partialWord = [NSString stringWithUTF8String:prefix.c_str()];
+    NSString* language = [this->spellChecker language];
+    NSRange range;
+
+    range.location = 0;
+    range.length = [partialWord length];
+
+    NSArray* words = [this->spellChecker completionsForPartialWordRange:range
+                                                               inString:partialWord
+                                                               language:language
+                                                 inSpellDocumentWithTag:0];
+
+    for (size_t i = 0; i < words.count && completions.size() < (size_t)limit; ++i) {
+      completions.push_back([[words objectAtIndex:i] UTF8String]);
+    }
+  }
+
+  return completions;
+}
+
 void MacSpellchecker::UpdateGlobalSpellchecker() {
   const NSString* autoLangauge = @"___AUTO_LANGUAGE";
   NSString* globalLang = currentGlobalLanguage ? currentGlobalLanguage : autoLangauge;
@@ -93,7 +93,8 @@ bool WindowsSpellchecker::IsSupported() {
   return !(g_COMFailed || (this->spellcheckerFactory == NULL));
 }
 
-bool WindowsSpellchecker::SetDictionary(const std::string& language, const std::string& path) {
+bool WindowsSpellchecker::SetDictionary(const std::string& language, const std::string& path,
+                                        const DictionaryOptions& options) {
   if (!this->spellcheckerFactory) {
     return false;
   }
@@ -125,6 +126,26 @@ bool WindowsSpellchecker::SetDictionary(const std::string& language, const std::
   return true;
 }
 
+bool WindowsSpellchecker::SetDictionaryFromBuffers(const char* affData, size_t affSize,
+                                                   const char* dicData, size_t dicSize,
+                                                   const DictionaryOptions& options) {
+  // NB: ISpellChecker can't load Hunspell dictionaries
+  return false;
+}
+
+bool WindowsSpellchecker::WriteSuggestionFile(const std::string& path,
+                                              const std::vector<std::string>& misspellings) {
+  return false;
+}
+
+std::vector<SuggestionStat> WindowsSpellchecker::TakeSuggestionStats() {
+  return std::vector<SuggestionStat>();
+}
+
+std::vector<LoadPhaseProfile> WindowsSpellchecker::GetLoadProfile() {
+  return std::vector<LoadPhaseProfile>();
+}
+
 std::vector<std::string> WindowsSpellchecker::GetAvailableDictionaries(const std::string& path) {
   HRESULT hr;
 
@@ -187,6 +208,20 @@ bool WindowsSpellchecker::IsMisspelled(const std::string& word) {
   return ret;
 }
 
+std::vector<WordInfo> WindowsSpellchecker::CheckWords(const std::vector<std::string>& words, bool withRoots) {
+  std::vector<WordInfo> result(words.size());
+  for (size_t i = 0; i < words.size(); ++i) {
+    result[i].misspelled = this->IsMisspelled(words[i]);
+  }
+  return result;
+}
+
+// NB: The ISpellChecker is created in the single-threaded apartment of the
+// main thread
+bool WindowsSpellchecker::CanCheckOnAnyThread() {
+  return false;
+}
+
 std::vector<MisspelledRange> WindowsSpellchecker::CheckSpelling(const uint16_t *text, size_t length) {
   std::vector<MisspelledRange> result;
 
@@ -214,9 +249,14 @@ std::vector<MisspelledRange> WindowsSpellchecker::CheckSpelling(const uint16_t *
   }
 
   errors->Release();
+  filter.Apply(text, result);
   return result;
 }
 
+void WindowsSpellchecker::SetTokenFilter(const TokenFilter& filter) {
+  this->filter = filter;
+}
+
 void WindowsSpellchecker::Add(const std::string& word) {
   if (this->currentSpellchecker == NULL) {
     return;
@@ -267,6 +307,44 @@ std::vector<std::string> WindowsSpellchecker::GetCorrectionsForMisspelling(const
   return ret;
 }
 
+std::string WindowsSpellchecker::GetAutocorrection(const std::string& word) {
+  if (this->currentSpellchecker == NULL) {
+    return std::string();
+  }
+
+  IEnumSpellingError* errors = NULL;
+  std::wstring wword = ToWString(word);
+  if (FAILED(this->currentSpellchecker->Check(wword.c_str(), &errors))) {
+    return std::string();
+  }
+
+  // NB: Only errors with a single confident replacement (the autocorrect
+  // list of the language) have CORRECTIVE_ACTION_REPLACE
+  std::string ret;
+  ISpellingError* error;
+  if (errors->Next(&error) == S_OK) {
+    CORRECTIVE_ACTION action;
+    LPWSTR replacement;
+    if (SUCCEEDED(error->get_CorrectiveAction(&action)) && action == CORRECTIVE_ACTION_REPLACE &&
+        SUCCEEDED(error->get_Replacement(&replacement))) {
+      std::wstring wcorr;
+      wcorr.assign(replacement);
+      ret = ToUTF8(wcorr);
+
+      CoTaskMemFree(replacement);
+    }
+    error->Release();
+  }
+
+  errors->Release();
+  return ret;
+}
+
+std::vector<std::string> WindowsSpellchecker::GetCompletions(const std::string& prefix, int limit, int maxEdits) {
+  // NB: ISpellChecker has no way to complete words
+  return std::vector<std::string>();
+}
+
 SpellcheckerImplementation* SpellcheckerFactory::CreateSpellchecker() {
   WindowsSpellchecker* ret = new WindowsSpellchecker();
   if (ret->IsSupported() && getenv("SPELLCHECKER_PREFER_HUNSPELL") == NULL) {
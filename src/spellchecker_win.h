@@ -13,18 +13,31 @@ public:
   WindowsSpellchecker();
   ~WindowsSpellchecker();
 
-  bool SetDictionary(const std::string& language, const std::string& path);
+  bool SetDictionary(const std::string& language, const std::string& path,
+                     const DictionaryOptions& options);
+  bool SetDictionaryFromBuffers(const char* affData, size_t affSize,
+                                const char* dicData, size_t dicSize,
+                                const DictionaryOptions& options);
   std::vector<std::string> GetAvailableDictionaries(const std::string& path);
 
   std::vector<std::string> GetCorrectionsForMisspelling(const std::string& word);
+  bool WriteSuggestionFile(const std::string& path, const std::vector<std::string>& misspellings);
+  std::vector<SuggestionStat> TakeSuggestionStats();
+  std::vector<LoadPhaseProfile> GetLoadProfile();
+  std::string GetAutocorrection(const std::string& word);
+  std::vector<std::string> GetCompletions(const std::string& prefix, int limit, int maxEdits);
   bool IsMisspelled(const std::string& word);
+  std::vector<WordInfo> CheckWords(const std::vector<std::string>& words, bool withRoots);
   std::vector<MisspelledRange> CheckSpelling(const uint16_t *text, size_t length);
+  bool CanCheckOnAnyThread();
+  void SetTokenFilter(const TokenFilter& filter);
   void Add(const std::string& word);
   void Remove(const std::string& word);
 
 private:
   ISpellChecker* currentSpellchecker;
   ISpellCheckerFactory* spellcheckerFactory;
+  TokenFilter filter;
 };
 
 }  // namespace spellchecker
@@ -0,0 +1,283 @@
+#include "suggestion_file.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace spellchecker {
+
+namespace {
+
+const char kMagic[4] = { 'H', 'S', 'U', 'G' };
+const uint32_t kFormatVersion = 1;
+const size_t kHeaderSize = 24;
+const size_t kBucketSize = 8;
+
+uint16_t GetU16(const unsigned char* p) {
+  return p[0] | (p[1] << 8);
+}
+
+uint32_t GetU32(const unsigned char* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint64_t GetU64(const unsigned char* p) {
+  return GetU32(p) | ((uint64_t)GetU32(p + 4) << 32);
+}
+
+void PutU16(std::string& out, uint16_t value) {
+  out += (char)(value & 0xFF);
+  out += (char)(value >> 8);
+}
+
+void PutU32(std::string& out, uint32_t value) {
+  PutU16(out, value & 0xFFFF);
+  PutU16(out, value >> 16);
+}
+
+void PutU64(std::string& out, uint64_t value) {
+  PutU32(out, (uint32_t)value);
+  PutU32(out, (uint32_t)(value >> 32));
+}
+
+// FNV-1a with a final mix of the bits, as the paragraph cache
+uint64_t Hash(const char* data, size_t size) {
+  uint64_t hash = SuggestionFile::Fingerprint(0, data, size);
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+}  // namespace
+
+SuggestionFile::SuggestionFile() : data(NULL), size(0) { }
+
+SuggestionFile::~SuggestionFile() {
+  Close();
+}
+
+void SuggestionFile::Close() {
+#ifndef _WIN32
+  if (data && buffer.empty()) {
+    munmap((void*)data, size);
+  }
+#endif
+  buffer.clear();
+  data = NULL;
+  size = 0;
+}
+
+bool SuggestionFile::Open(const std::string& path, uint64_t fingerprint) {
+  Close();
+
+#ifdef _WIN32
+  std::ifstream file(path.c_str(), std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  if (buffer.empty()) {
+    return false;
+  }
+  data = (const unsigned char*)buffer.data();
+  size = buffer.size();
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  data = (const unsigned char*)mapping;
+  size = info.st_size;
+#endif
+
+  uint32_t buckets = size >= kHeaderSize ? GetU32(data + 16) : 0;
+  if (size < kHeaderSize || memcmp(data, kMagic, 4) != 0 || GetU32(data + 4) != kFormatVersion ||
+      GetU64(data + 8) != fingerprint || buckets == 0 || (buckets & (buckets - 1)) != 0 ||
+      (size - kHeaderSize) / kBucketSize < buckets) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool SuggestionFile::Find(const std::string& word, std::vector<std::string>& suggestions) const {
+  if (!data) {
+    return false;
+  }
+
+  uint64_t hash = Hash(word.data(), word.size());
+  uint32_t buckets = GetU32(data + 16);
+  uint32_t mask = buckets - 1;
+
+  for (uint32_t i = 0, bucket = hash & mask; i < buckets; ++i, bucket = (bucket + 1) & mask) {
+    const unsigned char* p = data + kHeaderSize + bucket * kBucketSize;
+    uint32_t offset = GetU32(p + 4);
+    if (offset == 0) {
+      return false;
+    }
+    if (GetU32(p) != (uint32_t)(hash >> 32) || offset + 2 > size) {
+      continue;
+    }
+
+    // NB: The entries are checked against the size, the file may be damaged
+    size_t length = GetU16(data + offset);
+    const unsigned char* entry = data + offset + 2;
+    if (offset + 2 + length + 2 > size || length != word.size() ||
+        memcmp(entry, word.data(), length) != 0) {
+      continue;
+    }
+
+    size_t position = offset + 2 + length;
+    size_t count = GetU16(data + position);
+    position += 2;
+
+    suggestions.clear();
+    for (size_t j = 0; j < count && position + 2 <= size; ++j) {
+      size_t suggestionLength = GetU16(data + position);
+      position += 2;
+      if (position + suggestionLength > size) {
+        break;
+      }
+      suggestions.push_back(std::string((const char*)data + position, suggestionLength));
+      position += suggestionLength;
+    }
+    return true;
+  }
+  return false;
+}
+
+bool SuggestionFile::Write(const std::string& path, uint64_t fingerprint,
+                           const std::vector<std::string>& words,
+                           const std::vector<std::vector<std::string> >& suggestions) {
+  uint32_t buckets = 1;
+  while (buckets < 2 * words.size()) {
+    buckets <<= 1;
+  }
+
+  std::vector<uint32_t> hashes(buckets, 0);
+  std::vector<uint32_t> offsets(buckets, 0);
+  std::string entries;
+  uint32_t count = 0;
+  size_t base = kHeaderSize + buckets * kBucketSize;
+
+  for (size_t i = 0; i < words.size(); ++i) {
+    const std::string& word = words[i];
+    if (word.empty() || word.size() > 0xFFFF) {
+      continue;
+    }
+
+    uint64_t hash = Hash(word.data(), word.size());
+    uint32_t bucket = hash & (buckets - 1);
+    while (offsets[bucket] != 0) {
+      bucket = (bucket + 1) & (buckets - 1);
+    }
+    hashes[bucket] = hash >> 32;
+    offsets[bucket] = base + entries.size();
+    count++;
+
+    PutU16(entries, word.size());
+    entries += word;
+
+    std::vector<std::string> kept;
+    for (size_t j = 0; j < suggestions[i].size() && kept.size() < 0xFFFF; ++j) {
+      if (suggestions[i][j].size() <= 0xFFFF) {
+        kept.push_back(suggestions[i][j]);
+      }
+    }
+    PutU16(entries, kept.size());
+    for (size_t j = 0; j < kept.size(); ++j) {
+      PutU16(entries, kept[j].size());
+      entries += kept[j];
+    }
+  }
+
+  std::string header(kMagic, 4);
+  PutU32(header, kFormatVersion);
+  PutU64(header, fingerprint);
+  PutU32(header, buckets);
+  PutU32(header, count);
+
+  std::string table;
+  for (uint32_t i = 0; i < buckets; ++i) {
+    PutU32(table, hashes[i]);
+    PutU32(table, offsets[i]);
+  }
+
+  // NB: The file may be mapped by other spellcheckers, which would crash
+  // if it was truncated, so a new file is written next to it and renamed
+  // over it
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), ".%d.tmp", (int)getpid());
+  std::string temporary = path + suffix;
+
+  FILE* handle = fopen(temporary.c_str(), "wb");
+  if (!handle) {
+    return false;
+  }
+  bool written = fwrite(header.data(), 1, header.size(), handle) == header.size() &&
+    fwrite(table.data(), 1, table.size(), handle) == table.size() &&
+    fwrite(entries.data(), 1, entries.size(), handle) == entries.size();
+  if (fclose(handle) != 0 || !written) {
+    remove(temporary.c_str());
+    return false;
+  }
+
+#ifdef _WIN32
+  // NB: rename doesn't replace a file on Windows, where it is read in memory
+  remove(path.c_str());
+#endif
+  if (rename(temporary.c_str(), path.c_str()) != 0) {
+    remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+uint64_t SuggestionFile::Fingerprint(uint64_t fingerprint, const char* data, size_t size) {
+  uint64_t hash = fingerprint ? fingerprint : 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ (unsigned char)data[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+uint64_t SuggestionFile::FingerprintFile(uint64_t fingerprint, const std::string& path) {
+  FILE* handle = fopen(path.c_str(), "rb");
+  if (!handle) {
+    return 0;
+  }
+
+  char chunk[65536];
+  fingerprint = Fingerprint(fingerprint, "", 0);
+  for (size_t size; (size = fread(chunk, 1, sizeof(chunk), handle)) > 0; ) {
+    fingerprint = Fingerprint(fingerprint, chunk, size);
+  }
+  fclose(handle);
+  return fingerprint;
+}
+
+}  // namespace spellchecker
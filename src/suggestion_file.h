@@ -0,0 +1,59 @@
+#ifndef SRC_SUGGESTION_FILE_H_
+#define SRC_SUGGESTION_FILE_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace spellchecker {
+
+// Suggestions computed beforehand for common misspellings, in a hash table
+// file which is mapped in memory, so a new process has them without running
+// the suggestion engine. The file records a fingerprint of the dictionary
+// it was computed with, and is ignored with other dictionaries.
+//
+// Layout (little-endian): the header, then the buckets, then the entries.
+//   header: "HSUG", format version, fingerprint (64 bits), bucket count,
+//     entry count
+//   bucket: high 32 bits of the hash of the word, offset of its entry (0 for
+//     an empty bucket), probed linearly
+//   entry: length and UTF-8 bytes of the word, suggestion count, then the
+//     length and bytes of each suggestion (16-bit lengths and count)
+class SuggestionFile {
+public:
+  SuggestionFile();
+  ~SuggestionFile();
+
+  // Maps the file, if it exists and was computed for the dictionary with the
+  // fingerprint. Returns false otherwise.
+  bool Open(const std::string& path, uint64_t fingerprint);
+  void Close();
+
+  // Finds the suggestions of the word, returns false if it isn't in the
+  // file.
+  bool Find(const std::string& word, std::vector<std::string>& suggestions) const;
+
+  // Writes the suggestions of the words into a new file. A previous file is
+  // replaced, not modified, so the spellcheckers using it aren't affected.
+  static bool Write(const std::string& path, uint64_t fingerprint,
+                    const std::vector<std::string>& words,
+                    const std::vector<std::vector<std::string> >& suggestions);
+
+  // Fingerprint of dictionary data, chained through the calls from an
+  // initial 0.
+  static uint64_t Fingerprint(uint64_t fingerprint, const char* data, size_t size);
+
+  // Fingerprint of the contents of a file, 0 if it can't be read.
+  static uint64_t FingerprintFile(uint64_t fingerprint, const std::string& path);
+
+private:
+  const unsigned char* data;
+  size_t size;
+
+  // NB: Windows reads the file instead
+  std::vector<char> buffer;
+};
+
+}  // namespace spellchecker
+
+#endif  // SRC_SUGGESTION_FILE_H_
@@ -0,0 +1,42 @@
+#include <cwctype>
+
+#include "spellchecker.h"
+
+namespace spellchecker {
+
+bool TokenFilter::Skips(const uint16_t *word, size_t length) const {
+  if (length < minLength || (maxLength > 0 && length > maxLength)) {
+    return true;
+  }
+
+  if (!ignoreAllCaps && !ignoreMixedCase && !ignoreWordsWithDigits) {
+    return false;
+  }
+
+  bool lower = false, mixed = false, digits = false;
+  for (size_t i = 0; i < length; ++i) {
+    uint16_t c = word[i];
+    if (iswlower(c)) {
+      lower = true;
+    } else if (iswupper(c)) {
+      mixed = mixed || lower;
+    } else if (iswdigit(c)) {
+      digits = true;
+    }
+  }
+
+  return (ignoreAllCaps && !lower) || (ignoreMixedCase && mixed) ||
+    (ignoreWordsWithDigits && digits);
+}
+
+void TokenFilter::Apply(const uint16_t *text, std::vector<MisspelledRange>& ranges) const {
+  size_t j = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (!Skips(text + ranges[i].start, ranges[i].end - ranges[i].start)) {
+      ranges[j++] = ranges[i];
+    }
+  }
+  ranges.resize(j);
+}
+
+}  // namespace spellchecker
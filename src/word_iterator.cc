@@ -0,0 +1,57 @@
+#include <cwctype>
+
+#include "word_iterator.h"
+
+namespace spellchecker {
+
+WordIterator::WordIterator(const uint16_t *text, size_t length)
+  : text(text), length(length), position(0) { }
+
+bool WordIterator::Next(size_t *start, size_t *end) {
+  enum {
+    unknown,
+    in_separator,
+    in_word,
+  } state = in_separator;
+
+  // NB: Words end at the character after them, so the scan goes on from
+  // there in the separator state
+  for (size_t word_start = 0, i = position; i < length; i++) {
+    uint16_t c = text[i];
+
+    switch (state) {
+      case unknown:
+        if (iswpunct(c) || iswspace(c)) {
+          state = in_separator;
+        }
+        break;
+
+      case in_separator:
+        if (iswalpha(c)) {
+          word_start = i;
+          state = in_word;
+        } else if (!iswpunct(c) && !iswspace(c)) {
+          state = unknown;
+        }
+        break;
+
+      case in_word:
+        if (c == '\'' && i + 1 < length && iswalpha(text[i + 1])) {
+          i++;
+        } else if (c == 0 || iswpunct(c) || iswspace(c)) {
+          *start = word_start;
+          *end = i;
+          position = i + 1;
+          return true;
+        } else if (!iswalpha(c)) {
+          state = unknown;
+        }
+        break;
+    }
+  }
+
+  position = length;
+  return false;
+}
+
+}  // namespace spellchecker
@@ -0,0 +1,29 @@
+#ifndef SRC_WORD_ITERATOR_H_
+#define SRC_WORD_ITERATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace spellchecker {
+
+// Finds the words of a UTF-16 text, as the Hunspell checks and the
+// hyphenation see them: runs of letters (with apostrophes between letters)
+// ended by punctuation, whitespace or a NUL. Runs with other characters,
+// like digits or symbols, aren't words. NB: A word at the very end of the
+// text isn't ended, so the texts are passed with their NUL.
+class WordIterator {
+public:
+  WordIterator(const uint16_t *text, size_t length);
+
+  // Finds the next word, returns false at the end of the text.
+  bool Next(size_t *start, size_t *end);
+
+private:
+  const uint16_t *text;
+  size_t length;
+  size_t position;
+};
+
+}  // namespace spellchecker
+
+#endif  // SRC_WORD_ITERATOR_H_